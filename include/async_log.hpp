@@ -0,0 +1,31 @@
+// async_log.hpp - header file for async_log.cpp
+
+#ifndef _ASYNC_LOG_H_
+#define _ASYNC_LOG_H_
+
+#include "main.h"
+
+namespace async_log {
+  const std::size_t RECORD_TEXT = 62;     // bytes of text per ring record
+  const std::size_t RING_SIZE = 256;      // records, power of two
+  const std::size_t MAX_SINKS = 6;        // distinct output paths
+  const std::uint32_t FLUSH_PERIOD = 1000;    // ms, custom sinks are flushed at least this often
+
+  // Custom output for a sink, called from the writer task only. Without one
+  // the writer appends to the path with stdio.
+  struct SinkOps {
+    void (*write)(const char *data, std::size_t length);
+    void (*flush)();    // make everything written so far survive a power cut, every FLUSH_PERIOD
+  };
+
+  // Functions
+  void init();
+  int get_sink(const char *path, const SinkOps *ops = nullptr, bool binary = false);
+  FILE *open(const char *path, const SinkOps *ops = nullptr);
+  void request_flush();
+  bool push(int sink, const char *text, std::size_t length);
+  std::uint32_t get_dropped();
+  std::uint32_t get_written();
+}
+
+#endif  // #ifndef _ASYNC_LOG_H_
@@ -0,0 +1,24 @@
+// battery.hpp - header file for battery.cpp
+
+#ifndef _BATTERY_H_
+#define _BATTERY_H_
+
+#include "main.h"
+
+namespace battery {
+  // Voltage outputs are scaled as if the battery always sat at this
+  const double NOMINAL_VOLTAGE = 12800;    // mV
+
+  // Lowest battery we still run matches on, integrated velocity targets are
+  // only capped below it
+  const double MIN_RUN_VOLTAGE = 11800;    // mV
+
+  // Functions
+  void init();
+  double get_voltage();
+  double get_scale();
+  double compensate(double voltage);
+  double limit_velocity(double rpm, double max_rpm);
+}
+
+#endif  // #ifndef _BATTERY_H_
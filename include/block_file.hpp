@@ -0,0 +1,56 @@
+// block_file.hpp - header file for block_file.cpp
+
+#ifndef _BLOCK_FILE_H_
+#define _BLOCK_FILE_H_
+
+#include "main.h"
+
+/**
+ * Numbered, preallocated log files on the SD card, written in whole aligned
+ * blocks so writes during a match never extend the FAT chain or the
+ * directory entry. prepare() numbers and preallocates the next file (it
+ * takes a while) and begin() queues it, from any one task; write() and
+ * flush() run on the async_log writer only and switch to the queued file at
+ * the requested byte of the stream. Writes past the preallocated size are
+ * dropped, and only the newest `keep` files are kept.
+ */
+class BlockFile {
+ public:
+  static constexpr std::size_t BLOCK_SIZE = 512;    // SD sector
+
+  BlockFile(const char *icounterPath, const char *ipathFormat, std::size_t ifileSize, std::uint32_t ikeep);
+
+  bool prepare();
+  void begin(std::uint32_t iswitchAt = 0);
+  void write(const char *data, std::size_t length);
+  void flush();
+
+  std::uint32_t get_number() const;
+  const char *get_path() const;
+
+ protected:
+  const char *counter_path;
+  const char *path_format;    // printf format taking the file number
+  std::size_t file_size;
+  std::uint32_t keep;
+
+  std::uint32_t number = 0;
+  char path[32] = "";
+  FILE *prepared = nullptr;                  // from prepare(), until begin()
+  std::atomic<FILE *> next_file{nullptr};    // queued by begin(), taken by the writer
+  std::atomic<std::uint32_t> switch_at{0};   // stream byte the queued file starts at
+
+  // Writer task state
+  FILE *file = nullptr;
+  char block[BLOCK_SIZE];
+  std::size_t block_length = 0;
+  std::size_t block_offset = 0;
+  std::uint32_t received = 0;    // stream bytes passed to write()
+
+  std::uint32_t next_number();
+  bool preallocate(const char *ipath);
+  void write_block();
+  void take_next_file();
+};
+
+#endif  // #ifndef _BLOCK_FILE_H_
@@ -5,8 +5,20 @@
 
 #include "main.h"
 #include "ports.h"
+#include "odometry.hpp"
+#include "slip.hpp"
+#include "tracking.hpp"
+#include "feedforward.hpp"
+#include "drive_constants.h"
+#include "gain_schedule.hpp"
+#include "settle.hpp"
 
 // Functions
 std::shared_ptr<okapi::OdomChassisController> build_chassis_controller();
+std::shared_ptr<FeedforwardDriveModel> build_drive_model();
+std::shared_ptr<PublishedOdometry> get_published_odometry(const std::shared_ptr<okapi::OdomChassisController> &cc);
+bool move_until_contact(const std::shared_ptr<okapi::OdomChassisController> &cc, okapi::QLength distance, std::uint32_t timeout);
+bool move_through(const std::shared_ptr<okapi::OdomChassisController> &cc, okapi::QLength distance,
+                  okapi::QLength through, std::uint32_t timeout);
 
 #endif  // #ifndef _CHASSIS_H_
@@ -0,0 +1,25 @@
+// drive_constants.h - contains drivetrain feedforward #defines
+//
+// Nominal values worked out from the V5 motor spec (200rpm green, 3.25"
+// wheels: ~0.86 m/s free speed at 12V). Replace with measured constants.
+
+#ifndef _DRIVE_CONSTANTS_H_
+#define _DRIVE_CONSTANTS_H_
+
+// Linear: mV, mV per m/s, mV per m/s^2
+#define DRIVE_LINEAR_KS 600.0
+#define DRIVE_LINEAR_KV 13200.0
+#define DRIVE_LINEAR_KA 2000.0
+
+// Angular, in terms of each side's wheel speed while turning (scrub makes these higher)
+#define DRIVE_ANGULAR_KS 900.0
+#define DRIVE_ANGULAR_KV 13200.0
+#define DRIVE_ANGULAR_KA 2500.0
+
+// Feedback, mV per m/s of velocity error
+#define DRIVE_VELOCITY_KP 4000.0
+
+// Limit on the acceleration the feedforward is asked for, m/s^2
+#define DRIVE_MAX_ACCEL 4.0
+
+#endif  // #ifndef _DRIVE_CONSTANTS_H_
@@ -0,0 +1,58 @@
+// drive_filter.hpp - header file for drive_filter.cpp
+
+#ifndef _DRIVE_FILTER_H_
+#define _DRIVE_FILTER_H_
+
+#include "main.h"
+#include "enums.h"
+
+// Slew limits in full-stick per second, separate for speeding up and slowing down
+struct SlewProfile {
+  double forward_accel;
+  double forward_decel;
+  double turn_accel;
+  double turn_decel;
+  double deadband;           // stick fraction treated as 0
+  double turn_sensitivity;   // curvature drive, how hard the curve input bends the path
+  double quick_turn;         // curvature drive, below this throttle turn in place instead
+};
+
+// Wheel commands as fractions of max speed, feed to tank()
+struct DriveCommand {
+  double left;
+  double right;
+};
+
+/**
+ * Filter stage between the sticks and the drive model. Forward and turn are
+ * slew limited separately (a reversal decelerates to 0 before it
+ * accelerates), then mixed and normalized. Plain doubles only, nothing is
+ * allocated per tick.
+ */
+class DriveFilter {
+ public:
+  DriveFilter();
+
+  DriveCommand arcade(double forward, double yaw, DRIVETRAIN_MODE mode, std::uint32_t now);
+  DriveCommand tank(double left, double right, DRIVETRAIN_MODE mode, std::uint32_t now);
+  DriveCommand curvature(double throttle, double curve, DRIVETRAIN_MODE mode, std::uint32_t now);
+
+  void set_profile(DRIVETRAIN_MODE mode, const SlewProfile &profile);
+  const SlewProfile &get_profile(DRIVETRAIN_MODE mode) const;
+  void reset();
+
+ protected:
+  SlewProfile profiles[2];    // indexed by DRIVETRAIN_MODE
+  double forward_out = 0;
+  double turn_out = 0;
+  std::uint32_t last_time = 0;
+
+  DriveCommand filter(double forward, double turn, const SlewProfile &profile, std::uint32_t now);
+  double dt(std::uint32_t now);
+  DriveCommand mix(double forward, double turn) const;
+};
+
+// Functions
+double slew(double current, double target, double accel, double decel, double dt);
+
+#endif  // #ifndef _DRIVE_FILTER_H_
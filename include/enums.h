@@ -4,7 +4,24 @@
 #define _ENUMS_H_
 
 // Modes
+enum ROBOT_MODE {MODE_INITIALIZE, MODE_COMPETITION_INITIALIZE, MODE_DISABLED, MODE_AUTONOMOUS, MODE_OPCONTROL};
 enum DRIVETRAIN_MODE {FAST, SLOW};
-enum CONTROL_MODE {ARCADE, TANK};
+enum CONTROL_MODE {ARCADE, TANK, CURVATURE};
+enum DRIVER_PROFILE {DRIVER_LINEAR, DRIVER_SMOOTH};
+
+// Drive events (see slip.cpp)
+enum DRIVE_EVENT {DRIVE_OK, DRIVE_SLIP, DRIVE_STALL, DRIVE_COLLISION};
+
+// Shooter control modes (see shooter.cpp)
+enum SHOOTER_MODE {SHOOTER_TBH, SHOOTER_BANG_BANG, SHOOTER_FEEDFORWARD};
+
+// Ball indexer states (see indexer.cpp)
+enum INDEX_STATE {INDEX_DISABLED, INDEX_IDLE, INDEX_INTAKING, INDEX_STAGING, INDEX_HOLDING, INDEX_FIRING, INDEX_EJECTING};
+
+// Event journal records (see journal.cpp)
+enum JOURNAL_EVENT {EVENT_MODE, EVENT_BUTTON, EVENT_AUTON_STEP, EVENT_DRIVE, EVENT_CURRENT_CUT, EVENT_TASK_FAULT};
+
+// Pose components, OR together for landmark corrections
+enum POSE_COMPONENT {POSE_X = 1, POSE_Y = 2, POSE_THETA = 4, POSE_ALL = 7};
 
 #endif  // #ifndef _ENUMS_H_
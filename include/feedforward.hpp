@@ -0,0 +1,66 @@
+// feedforward.hpp - header file for feedforward.cpp
+
+#ifndef _FEEDFORWARD_H_
+#define _FEEDFORWARD_H_
+
+#include "main.h"
+
+// Drivetrain feedforward in mV: kS * sgn(v) + kV * v + kA * a
+struct Feedforward {
+  double kS;    // mV
+  double kV;    // mV per m/s
+  double kA;    // mV per m/s^2
+
+  double calculate(double velocity, double acceleration) const;
+};
+
+/**
+ * SkidSteerModel that treats every speed input as a wheel velocity target
+ * and drives it with moveVoltage(): characterized feedforward plus a small
+ * P correction on the measured wheel speed. Driver control and motion
+ * profiles (which call left()/right()) both go through it.
+ *
+ * Speeds are split into linear (average) and angular (half the difference)
+ * parts so turning gets its own constants.
+ */
+class FeedforwardDriveModel : public okapi::SkidSteerModel {
+ public:
+  FeedforwardDriveModel(std::shared_ptr<okapi::AbstractMotor> ileftSideMotor,
+                        std::shared_ptr<okapi::AbstractMotor> irightSideMotor,
+                        okapi::QLength iwheelDiameter,
+                        const Feedforward &ilinear,
+                        const Feedforward &iangular,
+                        double ikP,
+                        double imaxAccel,
+                        double imaxVelocity,
+                        double imaxVoltage = 12000);
+
+  // okapi::ChassisModel, all fractions of max velocity
+  void forward(double ispeed) override;
+  void driveVector(double iforwardSpeed, double iyaw) override;
+  void rotate(double ispeed) override;
+  void stop() override;
+  void tank(double ileftSpeed, double irightSpeed, double ithreshold = 0) override;
+  void arcade(double iforwardSpeed, double iyaw, double ithreshold = 0) override;
+  void left(double ispeed) override;
+  void right(double ispeed) override;
+
+  // Wheel velocity targets in m/s, call at a steady rate
+  void set_velocity(double left_velocity, double right_velocity);
+
+ protected:
+  double wheel_circumference;   // m
+  Feedforward linear;
+  Feedforward angular;
+  double kP;
+  double max_accel;
+
+  double last_left = 0;
+  double last_right = 0;
+  std::uint32_t last_time = 0;
+
+  double max_speed() const;
+  double measured_speed(const std::shared_ptr<okapi::AbstractMotor> &motor) const;
+};
+
+#endif  // #ifndef _FEEDFORWARD_H_
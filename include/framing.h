@@ -0,0 +1,78 @@
+// framing.h - COBS framing and CRC-16, shared by serial_link.cpp and tools/serial_receive.cpp
+
+#ifndef _FRAMING_H_
+#define _FRAMING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Frames on the wire: COBS([u8 channel][u32 time_us][payload][u16 crc]) 0x00.
+// COBS removes every 0x00 from the frame, so a receiver that joins mid-stream
+// resyncs at the next delimiter. The CRC covers everything before it.
+
+namespace framing {
+  const std::uint8_t DELIMITER = 0x00;
+
+  // Worst case COBS output for `length` input bytes, excluding the delimiter
+  constexpr std::size_t max_encoded(std::size_t length) {
+    return length + length / 254 + 1;
+  }
+
+  // CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+  inline std::uint16_t crc16(const std::uint8_t *data, std::size_t length) {
+    std::uint16_t crc = 0xFFFF;
+    for (std::size_t i = 0; i < length; i++) {
+      crc ^= static_cast<std::uint16_t>(data[i]) << 8;
+      for (int bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+  }
+
+  // Returns bytes written to out (at least max_encoded(length) long)
+  inline std::size_t cobs_encode(const std::uint8_t *in, std::size_t length, std::uint8_t *out) {
+    std::size_t code_pos = 0, write = 1;
+    std::uint8_t code = 1;
+
+    for (std::size_t i = 0; i < length; i++) {
+      if (in[i] == 0) {
+        out[code_pos] = code;
+        code_pos = write++;
+        code = 1;
+        continue;
+      }
+
+      out[write++] = in[i];
+      if (++code == 0xFF) {
+        out[code_pos] = code;
+        code_pos = write++;
+        code = 1;
+      }
+    }
+
+    out[code_pos] = code;
+    return write;
+  }
+
+  // Returns decoded length, 0 if the frame is malformed or needs more than
+  // out_size bytes
+  inline std::size_t cobs_decode(const std::uint8_t *in, std::size_t length, std::uint8_t *out,
+                                 std::size_t out_size) {
+    std::size_t read = 0, write = 0;
+
+    while (read < length) {
+      const std::uint8_t code = in[read++];
+      if (code == 0 || read + code - 1 > length) return 0;
+      if (write + code - 1 > out_size) return 0;
+
+      for (std::uint8_t i = 1; i < code; i++) out[write++] = in[read++];
+      if (code != 0xFF && read < length) {
+        if (write == out_size) return 0;
+        out[write++] = 0;
+      }
+    }
+
+    return write;
+  }
+}
+
+#endif  // #ifndef _FRAMING_H_
@@ -0,0 +1,56 @@
+// gain_schedule.hpp - header file for gain_schedule.cpp
+
+#ifndef _GAIN_SCHEDULE_H_
+#define _GAIN_SCHEDULE_H_
+
+#include "main.h"
+
+// One table row: gains (or gain multipliers) at a key
+struct GainRow {
+  double key;
+  double kP;
+  double kI;
+  double kD;
+};
+
+/**
+ * PID gains interpolated from two small tables: base gains keyed by target
+ * magnitude, and multipliers keyed by speed (fraction of max_velocity).
+ * Everything is then scaled by the battery compensation factor.
+ */
+class GainSchedule {
+ public:
+  GainSchedule(std::vector<GainRow> itargetRows, std::vector<GainRow> ivelocityRows, double imaxVelocity);
+
+  okapi::IterativePosPIDController::Gains lookup(double target, double velocity, double battery_scale) const;
+
+ protected:
+  std::vector<GainRow> target_rows;
+  std::vector<GainRow> velocity_rows;
+  double max_velocity;    // controller units per second
+
+  static GainRow interpolate(const std::vector<GainRow> &rows, double key);
+};
+
+/**
+ * IterativePosPIDController that re-picks its gains from a GainSchedule on
+ * every step, so the schedule is applied inside ChassisControllerPID's loop.
+ */
+class ScheduledPIDController : public okapi::IterativePosPIDController {
+ public:
+  ScheduledPIDController(std::shared_ptr<const GainSchedule> ischedule,
+                         const okapi::TimeUtil &itimeUtil,
+                         std::shared_ptr<okapi::Logger> ilogger = okapi::Logger::getDefaultLogger());
+
+  double step(double inewReading) override;
+  void setTarget(double itarget) override;
+  void reset() override;
+
+ protected:
+  std::shared_ptr<const GainSchedule> schedule;
+  double move_size = 0;       // |target| of the current move
+  double last_reading = 0;
+  std::uint32_t last_time = 0;
+};
+
+#endif  // #ifndef _GAIN_SCHEDULE_H_
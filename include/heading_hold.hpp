@@ -0,0 +1,33 @@
+// heading_hold.hpp - header file for heading_hold.cpp
+
+#ifndef _HEADING_HOLD_H_
+#define _HEADING_HOLD_H_
+
+#include "main.h"
+
+/**
+ * Driver assist for arcade drive. While the driver gives no yaw input and is
+ * driving, it locks the IMU heading and steers back to it with a small PID.
+ * Any yaw input releases it immediately. After a turn it waits for the robot
+ * to stop rotating before locking, so it doesn't snap back to where the
+ * turn was released.
+ */
+class HeadingHold {
+ public:
+  HeadingHold(double ikP = 0.02, double ikI = 0, double ikD = 0.001, double imaxCorrection = 0.3);
+
+  // Returns the yaw to use, heading in degrees (IMU rotation, unwrapped)
+  double step(double forward, double yaw, double heading, std::uint32_t now);
+  void set_gains(double ikP, double ikI, double ikD, double imaxCorrection);
+  bool is_holding() const;
+  void release();
+
+ protected:
+  okapi::IterativePosPIDController pid;
+  bool holding = false;
+  double last_heading = 0;
+  std::uint32_t last_time = 0;
+  std::uint32_t still_since = 0;
+};
+
+#endif  // #ifndef _HEADING_HOLD_H_
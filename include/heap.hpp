@@ -0,0 +1,70 @@
+// heap.hpp - header file for heap.cpp
+
+#ifndef _HEAP_H_
+#define _HEAP_H_
+
+#include "main.h"
+#include "enums.h"
+
+// Build with HEAP_INSTRUMENT=1 in the Makefile to wrap the newlib allocator
+// (monolithic link). Without it only the mallinfo-based numbers are live.
+#ifndef HEAP_INSTRUMENT
+#define HEAP_INSTRUMENT 0
+#endif
+
+// Abort when a NoAllocSection allocates, instead of just counting it
+#ifndef HEAP_FAIL_ON_ALLOC
+#define HEAP_FAIL_ON_ALLOC 0
+#endif
+
+namespace heap {
+  const std::size_t MODE_COUNT = 5;    // ROBOT_MODE values
+
+  struct Stats {
+    std::size_t arena;            // bytes the heap has taken from sbrk
+    std::size_t used;             // bytes in live allocations
+    std::size_t free;             // bytes free inside the arena
+    std::size_t free_chunks;      // more chunks for the same free bytes = more fragmentation
+    std::size_t largest_block;    // biggest single allocation that would succeed right now
+
+    // Instrumented builds only
+    std::size_t peak;                           // highest `used` seen
+    std::uint32_t allocs[MODE_COUNT];           // malloc/realloc calls per mode
+    std::uint32_t frees[MODE_COUNT];
+    std::uint32_t violations;                   // allocations inside a NoAllocSection
+  };
+
+  /**
+   * Marks a stretch of a control loop as allocation free. In instrumented
+   * builds any malloc from this task while one is alive counts as a
+   * violation, or aborts with HEAP_FAIL_ON_ALLOC. Compiles to nothing
+   * otherwise.
+   */
+  class NoAllocSection {
+   public:
+    NoAllocSection(const char *iname);
+    ~NoAllocSection();
+
+    NoAllocSection(const NoAllocSection &) = delete;
+    NoAllocSection &operator=(const NoAllocSection &) = delete;
+
+#if HEAP_INSTRUMENT
+   protected:
+    int slot;
+#endif
+  };
+
+  // Functions
+  void set_mode(ROBOT_MODE mode);
+  Stats get_stats();
+  std::size_t find_largest_block();
+  void log_report(const char *when);
+  void print_report();
+}
+
+#if !HEAP_INSTRUMENT
+inline heap::NoAllocSection::NoAllocSection(const char *) {}
+inline heap::NoAllocSection::~NoAllocSection() {}
+#endif
+
+#endif  // #ifndef _HEAP_H_
@@ -0,0 +1,35 @@
+// indexer.hpp - header file for indexer.cpp
+
+#ifndef _INDEXER_H_
+#define _INDEXER_H_
+
+#include "main.h"
+#include "ports.h"
+#include "enums.h"
+
+namespace indexer {
+  // Thresholds and speeds, line tracker values are raw 0-4095 (lower = more reflective)
+  struct Config {
+    int ball_threshold = 2000;          // line tracker reads below this with a ball in front
+
+    double intake_velocity = 200;       // rpm, green intakes
+    double stage_velocity = 250;        // rpm, rollers lifting a ball to the top sensor
+    double fire_velocity = 600;         // rpm, blue rollers
+    double feed_velocity = 200;         // rpm, intakes pushing the next ball while firing
+
+    std::uint32_t fire_timeout = 700;   // ms, give up on a shot that never registers
+    std::uint32_t stage_timeout = 1500; // ms, ball never reached the top sensor
+    int max_balls = 3;
+  };
+
+  // Functions
+  void init(const Config &config = Config());
+  void set_enabled(bool enabled);
+  void set_intake(bool intake);
+  void set_eject(bool eject);
+  void fire();
+  INDEX_STATE get_state();
+  int get_balls();
+}
+
+#endif  // #ifndef _INDEXER_H_
@@ -0,0 +1,31 @@
+// journal.hpp - header file for journal.cpp
+
+#ifndef _JOURNAL_H_
+#define _JOURNAL_H_
+
+#include "main.h"
+#include "enums.h"
+
+namespace journal {
+  const char *const PATH = "/usd/events.csv";
+  const std::size_t RING_SIZE = 512;    // events, power of two
+
+  // One fixed-size record
+  struct Event {
+    std::uint64_t time;     // us since the brain started
+    std::uint8_t type;      // JOURNAL_EVENT
+    std::uint8_t arg;       // mode, button, step, port... by type
+    std::int32_t value;
+  };
+
+  // Functions
+  void init();
+  void record(JOURNAL_EVENT type, std::uint8_t arg = 0, std::int32_t value = 0);
+  void set_mode(ROBOT_MODE mode);
+  void dump();
+  std::size_t get_recent(Event *out, std::size_t max);
+  void print_recent(std::size_t max);
+  std::uint32_t get_lost();
+}
+
+#endif  // #ifndef _JOURNAL_H_
@@ -0,0 +1,88 @@
+// joystick.hpp - header file for joystick.cpp
+
+#ifndef _JOYSTICK_H_
+#define _JOYSTICK_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+
+#include "enums.h"
+
+namespace joystick {
+  // The controller reports -127..127, one table entry per raw step
+  constexpr std::size_t RESOLUTION = 127;
+
+  // Response curve sampled at every stick position, magnitude only
+  struct CurveTable {
+    std::array<float, RESOLUTION + 1> values;
+
+    // Stick fraction in, shaped fraction out, sign preserved
+    float lookup(double x) const {
+      const int index = static_cast<int>(std::abs(x) * RESOLUTION + 0.5);
+      const float value = values[index > static_cast<int>(RESOLUTION) ? RESOLUTION : index];
+      return x < 0 ? -value : value;
+    }
+  };
+
+  // Curves for every stick a control mode reads
+  struct DriveCurves {
+    const CurveTable *forward;      // left Y (tank: both Y), curvature throttle
+    const CurveTable *turn;         // right X
+    const CurveTable *fine_turn;    // left X, arcade only
+  };
+
+  // constexpr helpers, std::exp isn't constexpr
+  constexpr double exp(double x) {
+    if (x < 0) return 1.0 / exp(-x);
+    if (x > 0.5) {
+      const double half = exp(x / 2.0);
+      return half * half;
+    }
+
+    double sum = 1, term = 1;
+    for (int n = 1; n < 16; n++) {
+      term *= x / n;
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Map [deadband, 1] onto [0, 1] so the curve starts right at the deadband edge
+  constexpr double rescale(double x, double deadband) {
+    return x <= deadband ? 0 : (x - deadband) / (1.0 - deadband);
+  }
+
+  constexpr CurveTable linear(double deadband, double scale) {
+    CurveTable table{};
+    for (std::size_t i = 0; i <= RESOLUTION; i++) {
+      table.values[i] = scale * rescale(static_cast<double>(i) / RESOLUTION, deadband);
+    }
+    return table;
+  }
+
+  // weight 0 is linear, 1 is pure cubic
+  constexpr CurveTable cubic(double deadband, double weight, double scale) {
+    CurveTable table{};
+    for (std::size_t i = 0; i <= RESOLUTION; i++) {
+      const double r = rescale(static_cast<double>(i) / RESOLUTION, deadband);
+      table.values[i] = scale * (weight * r * r * r + (1.0 - weight) * r);
+    }
+    return table;
+  }
+
+  // Larger k is flatter near center and steeper near full stick
+  constexpr CurveTable exponential(double deadband, double k, double scale) {
+    CurveTable table{};
+    for (std::size_t i = 0; i <= RESOLUTION; i++) {
+      const double r = rescale(static_cast<double>(i) / RESOLUTION, deadband);
+      table.values[i] = scale * (exp(k * r) - 1.0) / (exp(k) - 1.0);
+    }
+    return table;
+  }
+
+  // Functions
+  const DriveCurves &get_curves(DRIVER_PROFILE profile, CONTROL_MODE control, DRIVETRAIN_MODE drivetrain);
+}
+
+#endif  // #ifndef _JOYSTICK_H_
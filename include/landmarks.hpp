@@ -0,0 +1,36 @@
+// landmarks.hpp - header file for landmarks.cpp
+
+#ifndef _LANDMARKS_H_
+#define _LANDMARKS_H_
+
+#include "main.h"
+#include "enums.h"
+
+namespace landmarks {
+  // One applied correction, all states are CARTESIAN like the chassis
+  struct Correction {
+    std::uint32_t time;         // ms
+    const char *source;         // must be a string literal
+    int components;             // POSE_COMPONENT mask
+    okapi::OdomState before;
+    okapi::OdomState after;
+  };
+
+  const okapi::QLength TILE_SIZE = 24_in;
+  const std::size_t AUDIT_SIZE = 32;    // corrections kept, oldest dropped first
+
+  // Functions
+  okapi::OdomState snap(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                        const okapi::OdomState &truth, int components, const char *source);
+  okapi::OdomState wall_contact(const std::shared_ptr<okapi::OdomChassisController> &cc, const char *source);
+  okapi::OdomState wall_contact(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                                okapi::QLength wall, okapi::QLength offset, bool backwards, const char *source);
+  okapi::OdomState goal_alignment(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                                  const okapi::Point &goal, okapi::QLength standoff, const char *source);
+  okapi::OdomState tile(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                        int columns, int rows, const char *source);
+  std::vector<Correction> get_corrections();
+  void print_corrections();
+}
+
+#endif  // #ifndef _LANDMARKS_H_
@@ -5,7 +5,33 @@
 
 #include "main.h"
 
+// Compile-time log threshold, same numbering as okapi::Logger::LogLevel
+// (0 off, 1 error, 2 warn, 3 info, 4 debug). Calls above it are discarded by
+// `if constexpr`: still type checked, but no branch, lambda or string code is
+// emitted. The runtime level ("log.level" param, warn by default) filters
+// whatever is left, so the settle, landmark, power and heap reports (info)
+// are compiled in but only logged after "loglevel 3" on the console.
+// Override from the Makefile, e.g. EXTRA_CXXFLAGS=-DLOG_LEVEL=4 for a debug image.
+// tools/log_level_compare.sh and the "logbench" console command measure the cost.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 3
+#endif
+
+#define LOG_AT_LEVEL(level, method, msg)                                       \
+  do {                                                                         \
+    if constexpr (LOG_LEVEL >= (level)) {                                      \
+      okapi::Logger::getDefaultLogger()->method([=]() { return std::string(msg); }); \
+    }                                                                          \
+  } while (0)
+
+#define DEBUG_LOG(msg) LOG_AT_LEVEL(4, debug, msg)
+#define INFO_LOG(msg) LOG_AT_LEVEL(3, info, msg)
+#define WARN_LOG(msg) LOG_AT_LEVEL(2, warn, msg)
+#define ERROR_LOG(msg) LOG_AT_LEVEL(1, error, msg)
+
 // Functions
 std::shared_ptr<okapi::Logger> build_logger(bool competition, bool debug);
+void apply_log_level();
+void bench_logging(std::uint32_t iterations);
 
 #endif  // #ifndef _LOGGING_H_
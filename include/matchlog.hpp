@@ -0,0 +1,22 @@
+// matchlog.hpp - header file for matchlog.cpp
+
+#ifndef _MATCHLOG_H_
+#define _MATCHLOG_H_
+
+#include "main.h"
+
+namespace matchlog {
+  const char *const COUNTER_PATH = "/usd/match_count.txt";
+  const char *const PATH_FORMAT = "/usd/match_%03lu.txt";
+  const std::size_t FILE_SIZE = 512 * 1024;    // preallocated per match, zero filled, writes stop there
+  const std::uint32_t KEEP = 16;               // older match logs are deleted
+
+  // Functions
+  FILE *open();
+  FILE *reopen();
+  void flush();
+  const char *get_path();
+  std::uint32_t get_match();
+}
+
+#endif  // #ifndef _MATCHLOG_H_
@@ -0,0 +1,35 @@
+// monitor.hpp - header file for monitor.cpp
+
+#ifndef _MONITOR_H_
+#define _MONITOR_H_
+
+#include "main.h"
+
+namespace monitor {
+  const std::size_t MAX_TASKS = 32;
+
+  // Thresholds for flagging, stack sizes in words (4 bytes)
+  struct Config {
+    std::uint32_t period = 2000;          // ms between samples
+    double overload_cpu = 30;             // %, a single non-idle task above this
+    std::uint32_t low_stack = 256;        // words never used, below this we're close to overflow
+    std::uint32_t oversized_stack = 0x1800;  // words never used, above this the stack could shrink
+  };
+
+  struct TaskReport {
+    char name[TASK_NAME_MAX_LEN];
+    std::uint32_t priority;
+    double cpu;                    // % of the last period, -1 if runtime stats are off
+    std::uint32_t stack_free;      // words, lowest it has been
+    bool overloaded;
+    bool low_stack;
+    bool oversized;
+  };
+
+  // Functions
+  void init(const Config &config = Config());
+  std::size_t get_report(TaskReport *out, std::size_t max);
+  void print_report();
+}
+
+#endif  // #ifndef _MONITOR_H_
@@ -0,0 +1,67 @@
+// odometry.hpp - header file for odometry.cpp
+
+#ifndef _ODOMETRY_H_
+#define _ODOMETRY_H_
+
+#include "main.h"
+#include "seqlock.hpp"
+
+// Pose + velocity published by the odometry task, always FRAME_TRANSFORMATION
+struct PoseSnapshot {
+  double x;                   // m
+  double y;                   // m
+  double theta;               // rad
+  double linear_velocity;     // m/s, along heading
+  double angular_velocity;    // rad/s
+  std::uint64_t timestamp;    // us, from timing::micros()
+  std::uint32_t step;         // odometry steps since construction
+};
+
+/**
+ * Wraps an okapi Odometry and publishes its state through a SeqLock after
+ * every step. getState() never blocks the odometry task, so auton and
+ * opcontrol can poll pose as often as they like.
+ */
+class PublishedOdometry : public okapi::Odometry {
+ public:
+  explicit PublishedOdometry(std::shared_ptr<okapi::Odometry> iodometry);
+
+  // okapi::Odometry
+  void setScales(const okapi::ChassisScales &ichassisScales) override;
+  void step() override;
+  okapi::OdomState getState(const okapi::StateMode &imode = okapi::StateMode::FRAME_TRANSFORMATION) const override;
+  void setState(const okapi::OdomState &istate,
+                const okapi::StateMode &imode = okapi::StateMode::FRAME_TRANSFORMATION) override;
+  std::shared_ptr<okapi::ReadOnlyChassisModel> getModel() override;
+  okapi::ChassisScales getScales() override;
+
+  // Lock-free read of the full snapshot
+  PoseSnapshot get_snapshot() const;
+
+  // Bumped on every publish
+  std::uint32_t get_version() const;
+
+  // Read-modify-write the state in one step, so the odometry task can't
+  // integrate in between. Returns the state before the change.
+  okapi::OdomState modify_state(const std::function<okapi::OdomState(const okapi::OdomState &)> &imodifier,
+                                const okapi::StateMode &imode = okapi::StateMode::FRAME_TRANSFORMATION);
+
+  // While the predicate is true, steps are computed but thrown away
+  void set_freeze_when(std::function<bool()> ipredicate);
+  std::uint32_t get_frozen_steps() const;
+
+ protected:
+  std::shared_ptr<okapi::Odometry> odometry;
+  SeqLock<PoseSnapshot> published;
+  CrossplatformMutex writer_mutex;   // step() vs setState(), readers never touch it
+  std::uint32_t steps = 0;
+  std::function<bool()> freeze_when;
+  std::atomic<std::uint32_t> frozen_steps{0};
+
+  void publish(bool reset_velocity);
+};
+
+// Functions
+okapi::OdomState to_odom_state(const PoseSnapshot &snapshot, const okapi::StateMode &mode);
+
+#endif  // #ifndef _ODOMETRY_H_
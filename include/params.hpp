@@ -0,0 +1,91 @@
+// params.hpp - header file for params.cpp
+
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include "main.h"
+
+#include <cstring>
+
+namespace params {
+  const char *const PATH = "/usd/params.txt";
+
+  /**
+   * A named, range-checked tunable. Define one at namespace scope where it's
+   * used and read it with get(), a single relaxed atomic load. Values change
+   * through set() (serial console or the params file), never by the owner.
+   */
+  class ParamBase {
+   public:
+    ParamBase(const char *iname);
+    virtual ~ParamBase() = default;
+
+    const char *get_name() const;
+    ParamBase *get_next() const;
+
+    virtual bool parse(const char *text) = 0;    // validate + store, false if rejected
+    virtual void format(char *out, std::size_t size) const = 0;
+    virtual void format_range(char *out, std::size_t size) const = 0;
+
+   protected:
+    const char *name;
+    ParamBase *next;    // intrusive registry list, built during static init
+  };
+
+  template <typename T>
+  class Param : public ParamBase {
+    static_assert(std::is_arithmetic<T>::value, "Param needs a number or bool");
+
+   public:
+    Param(const char *iname, T idefault, T imin, T imax)
+      : ParamBase(iname), value(idefault), min(imin), max(imax) {}
+
+    T get() const {
+      return value.load(std::memory_order_relaxed);
+    }
+
+    operator T() const {
+      return get();
+    }
+
+    bool parse(const char *text) override {
+      if constexpr (std::is_same<T, bool>::value) {
+        if (std::strcmp(text, "true") == 0) text = "1";
+        else if (std::strcmp(text, "false") == 0) text = "0";
+      }
+
+      // Written so NaN fails the range check too
+      char *end = nullptr;
+      const double parsed = std::strtod(text, &end);
+      if (end == text || !(parsed >= min && parsed <= max)) return false;
+      if (std::is_integral<T>::value && parsed != std::floor(parsed)) return false;
+
+      value.store(static_cast<T>(parsed), std::memory_order_relaxed);
+      return true;
+    }
+
+    void format(char *out, std::size_t size) const override {
+      if constexpr (std::is_same<T, bool>::value) snprintf(out, size, "%s", get() ? "true" : "false");
+      else snprintf(out, size, "%g", static_cast<double>(get()));
+    }
+
+    void format_range(char *out, std::size_t size) const override {
+      snprintf(out, size, "[%g, %g]", static_cast<double>(min), static_cast<double>(max));
+    }
+
+   protected:
+    std::atomic<T> value;
+    const T min;
+    const T max;
+  };
+
+  // Functions
+  void init();
+  bool set(const char *name, const char *value, const char *source);
+  ParamBase *find(const char *name);
+  std::uint32_t get_version();
+  int load(const char *path = PATH);
+  bool save(const char *path = PATH);
+}
+
+#endif  // #ifndef _PARAMS_H_
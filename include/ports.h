@@ -15,4 +15,19 @@
 #define ROLLERS_FRONT_MOTOR_PORT 14
 #define ROLLERS_BACK_MOTOR_PORT 16
 
+// Sensor ports
+#define IMU_PORT 20
+
+// Tracking wheel encoders (ADI top/bottom pairs, see tracking_config.h)
+#define TRACKING_LEFT_TOP_PORT 'A'
+#define TRACKING_LEFT_BOTTOM_PORT 'B'
+#define TRACKING_RIGHT_TOP_PORT 'C'
+#define TRACKING_RIGHT_BOTTOM_PORT 'D'
+#define TRACKING_MIDDLE_TOP_PORT 'E'
+#define TRACKING_MIDDLE_BOTTOM_PORT 'F'
+
+// Ball indexing line trackers (see indexer.cpp)
+#define INDEX_INTAKE_SENSOR_PORT 'G'    // just past the intake rollers
+#define INDEX_TOP_SENSOR_PORT 'H'       // staged position under the shooter
+
 #endif  // #ifndef _PORTS_H_
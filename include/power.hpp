@@ -0,0 +1,34 @@
+// power.hpp - header file for power.cpp
+
+#ifndef _POWER_H_
+#define _POWER_H_
+
+#include "main.h"
+#include "ports.h"
+
+namespace power {
+  // Budget and thermal limits, currents in mA, temperatures in C
+  struct Config {
+    double total_budget = 16000;        // shared across all eight motors
+    double motor_max = 2500;            // V5 motor hardware limit
+    double motor_floor = 600;           // every motor keeps at least this
+    double headroom = 1.5;              // a motor may grow this much past its measured draw per cycle...
+    double margin = 400;                // ...or by this much, whichever is more
+    double saturated = 0.9;             // drawing this fraction of its limit = wants its full cap
+
+    double derate_start = 45;           // start backing off here...
+    double derate_end = 55;             // ...reach derate_min here, V5 firmware halves power at 55
+    double derate_min = 0.5;            // fraction of motor_max at derate_end
+
+  };
+
+  // Allocation priority, lower is served first
+  enum PRIORITY {PRIORITY_DRIVE, PRIORITY_ROLLERS, PRIORITY_INTAKES};
+
+  // Functions
+  void init(const Config &config = Config());
+  std::int32_t get_limit(std::uint8_t port);
+  std::uint32_t get_cut_count();
+}
+
+#endif  // #ifndef _POWER_H_
@@ -0,0 +1,97 @@
+// seqlock.hpp - double-buffered seqlock for publishing small POD snapshots
+
+#ifndef _SEQLOCK_H_
+#define _SEQLOCK_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Single-writer, many-reader snapshot. The writer fills the slot readers are
+ * NOT looking at and then flips the index, so it never waits on readers and
+ * readers never take a lock.
+ *
+ * Readers only retry if the writer laps them twice during one copy, which on
+ * the brain can only happen to a reader of lower priority than the writer.
+ * A higher priority reader can't be interrupted by the writer at all, so it
+ * never spins.
+ *
+ * Writers must be serialized by the owner (see PublishedOdometry).
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+  static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+
+  struct Slot {
+    std::atomic<std::uint32_t> sequence{0};     // odd while being written
+    std::array<std::atomic<std::uint32_t>, WORDS> data{};
+  };
+
+ public:
+  SeqLock() = default;
+  explicit SeqLock(const T &initial) { store(initial); }
+
+  SeqLock(const SeqLock &) = delete;
+  SeqLock &operator=(const SeqLock &) = delete;
+
+  // Publish a new value (writer side)
+  void store(const T &value) {
+    std::uint32_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(T));
+
+    const std::uint32_t next = active.load(std::memory_order_relaxed) ^ 1;
+    Slot &slot = slots[next];
+
+    const std::uint32_t seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (std::size_t i = 0; i < WORDS; i++) {
+      slot.data[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    slot.sequence.store(seq + 2, std::memory_order_release);
+    active.store(next, std::memory_order_release);
+    writes.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Read the latest complete value (reader side)
+  T load() const {
+    std::uint32_t words[WORDS];
+
+    while (true) {
+      const Slot &slot = slots[active.load(std::memory_order_acquire)];
+
+      const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+      if (before & 1) continue;
+
+      for (std::size_t i = 0; i < WORDS; i++) {
+        words[i] = slot.data[i].load(std::memory_order_relaxed);
+      }
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == before) break;
+    }
+
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+  // Number of completed store() calls, lets readers detect fresh data cheaply
+  std::uint32_t version() const {
+    return writes.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::array<Slot, 2> slots{};
+  std::atomic<std::uint32_t> active{0};
+  std::atomic<std::uint32_t> writes{0};
+};
+
+#endif  // #ifndef _SEQLOCK_H_
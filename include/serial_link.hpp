@@ -0,0 +1,26 @@
+// serial_link.hpp - header file for serial_link.cpp
+
+#ifndef _SERIAL_LINK_H_
+#define _SERIAL_LINK_H_
+
+#include "main.h"
+#include "telemetry_format.h"
+
+namespace serial_link {
+  // Per-channel rates in Hz, 0 turns a channel off
+  struct Config {
+    std::uint32_t pose_rate = 100;
+    std::uint32_t motors_rate = 50;
+    std::uint32_t inputs_rate = 50;
+  };
+
+  // Functions
+  void init(const Config &config = Config());
+  void set_enabled(bool enabled);
+  bool is_enabled();
+  void set_rate(telemetry::CHANNEL_ID channel, std::uint32_t rate);
+  std::uint32_t get_frames();
+  std::uint32_t get_dropped();
+}
+
+#endif  // #ifndef _SERIAL_LINK_H_
@@ -0,0 +1,61 @@
+// settle.hpp - header file for settle.cpp
+
+#ifndef _SETTLE_H_
+#define _SETTLE_H_
+
+#include "main.h"
+
+namespace settle {
+  // Thresholds, error units are whatever the controller uses (motor ticks here)
+  struct Config {
+    double at_target_error = 50;
+    double at_target_derivative = 5;           // per step
+    std::uint32_t at_target_time = 250;        // ms, okapi's default fallback
+    double stopped_velocity = 3;               // rpm, "provably stopped"
+    std::uint32_t stopped_time = 30;           // ms stopped inside the band to finish early
+    bool report = true;                        // only one util per move should report
+  };
+
+  // How a move finished
+  struct Report {
+    std::uint32_t move_time;    // ms from the first check to settled
+    std::uint32_t settle_time;  // ms of that spent inside the error band
+    std::uint32_t saved;        // ms earlier than plain SettledUtil would have said
+    bool early;                 // stopped-in-band exit
+    bool through;               // settle-through exit, still rolling
+  };
+
+  /**
+   * SettledUtil that also watches the motor's velocity. Once the error is in
+   * band, barely changing and the motor has stopped for stopped_time, the move
+   * is done, without waiting out at_target_time. Falls back to okapi's rule
+   * otherwise. After settle_through(), the next move is also done as soon as
+   * its error is under that, while still moving.
+   */
+  class VelocitySettledUtil : public okapi::SettledUtil {
+   public:
+    VelocitySettledUtil(std::function<double()> ivelocity, const Config &iconfig);
+
+    bool isSettled(double ierror) override;
+    void reset() override;
+
+   protected:
+    std::function<double()> velocity;
+    Config config;
+    double through_error = 0;
+    std::uint32_t move_start = 0;
+    std::uint32_t band_start = 0;
+    std::uint32_t stopped_start = 0;
+    bool settled = false;
+
+    bool finish(std::uint32_t now, bool early, bool through);
+  };
+
+  // Functions
+  okapi::TimeUtil build_time_util(std::function<double()> velocity, const Config &config = Config());
+  void settle_through(double error);
+  Report get_last_report();
+  std::uint32_t get_total_saved();
+}
+
+#endif  // #ifndef _SETTLE_H_
@@ -0,0 +1,19 @@
+// shooter.hpp - header file for shooter.cpp
+
+#ifndef _SHOOTER_H_
+#define _SHOOTER_H_
+
+#include "main.h"
+#include "ports.h"
+#include "enums.h"
+#include "shooter_controller.hpp"
+
+namespace shooter {
+  // Functions
+  void init(const Config &config = Config());
+  void set_target(double rpm);
+  double get_velocity();
+  std::uint32_t get_shots();
+}
+
+#endif  // #ifndef _SHOOTER_H_
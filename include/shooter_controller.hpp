@@ -0,0 +1,60 @@
+// shooter_controller.hpp - header file for shooter_controller.cpp
+//
+// No PROS dependencies, so host tools can build the controller too (see
+// tools/shooter_check.cpp).
+
+#ifndef _SHOOTER_CONTROLLER_H_
+#define _SHOOTER_CONTROLLER_H_
+
+#include <cstdint>
+
+#include "enums.h"
+
+namespace shooter {
+  // Tuning, velocities are roller rpm (blue cartridges, 600 max)
+  struct Config {
+    SHOOTER_MODE mode = SHOOTER_TBH;
+
+    double tbh_gain = 0.00002;          // output per rpm of error per step
+    double kV = 12000.0 / 600.0;        // mV per rpm (feedforward + bang-bang hold)
+    double kP = 15;                     // mV per rpm of error (feedforward mode)
+    double bang_band = 20;              // rpm under target before bang-bang goes full
+
+    double dip_velocity = 60;           // rpm drop below target that counts as a ball
+    double dip_current = 1800;          // mA, ball load shows up as a current spike
+    std::uint32_t boost_time = 120;     // ms of full voltage after a ball
+    double recovered_band = 15;         // rpm, boost ends early once back this close
+  };
+
+  /**
+   * Iterative roller velocity controller, in the style of okapi's
+   * IterativeVelPIDController: step() takes the measured velocity (and
+   * current, for ball detection) and returns a voltage in mV.
+   */
+  class ShooterController {
+   public:
+    explicit ShooterController(const Config &iconfig = Config());
+
+    double step(double velocity, double current, std::uint32_t now);
+    void set_target(double itarget);
+    double get_target() const;
+    std::uint32_t get_shots() const;
+    bool is_boosting() const;
+    void reset();
+
+   protected:
+    Config config;
+    double target = 0;
+    double output = 0;          // fraction of 12V (TBH state)
+    double tbh = 0;             // take-back-half memory
+    double last_error = 0;
+    std::uint32_t boost_until = 0;
+    std::uint32_t shots = 0;
+    bool ball_seen = false;     // one shot per dip
+    bool at_speed = false;      // dips only count once we've been near target
+
+    double control(double velocity);
+  };
+}
+
+#endif  // #ifndef _SHOOTER_CONTROLLER_H_
@@ -0,0 +1,38 @@
+// slip.hpp - header file for slip.cpp
+
+#ifndef _SLIP_H_
+#define _SLIP_H_
+
+#include "main.h"
+#include "ports.h"
+#include "enums.h"
+
+namespace slip {
+  // Detector thresholds, defaults are for our green 3.25" drive
+  struct Config {
+    double wheel_diameter = 0.08255;   // m
+    double wheel_track = 0.254;        // m
+
+    double yaw_tolerance = 45;         // deg/s, wheel vs. IMU yaw rate
+    double accel_tolerance = 0.5;      // g, wheel vs. IMU acceleration
+    double collision_accel = 1.2;      // g, horizontal IMU spike
+    double stall_voltage = 4000;       // mV, average applied drive voltage
+    double stall_velocity = 5;         // rpm, below this the wheels are "stopped"
+
+    int confirm_cycles = 3;            // slip must persist this many cycles
+    int stall_cycles = 15;             // longer, so normal accel from rest isn't a stall
+    std::uint32_t hold_time = 150;     // ms an event stays active after it clears
+
+    bool freeze_odometry = true;       // drop odom integration during slip/collision
+  };
+
+  // Functions
+  void init(const Config &config = Config());
+  DRIVE_EVENT get_event();
+  bool should_freeze_odometry();
+  void set_freeze_odometry(bool freeze);
+  std::uint32_t get_event_count(DRIVE_EVENT event);
+  std::uint32_t get_contact_count();
+}
+
+#endif  // #ifndef _SLIP_H_
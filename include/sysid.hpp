@@ -0,0 +1,34 @@
+// sysid.hpp - header file for sysid.cpp
+
+#ifndef _SYSID_H_
+#define _SYSID_H_
+
+#include "main.h"
+#include "ports.h"
+
+namespace sysid {
+  // Test settings, the robot needs ~2.5m clear in front and behind it.
+  // Hold B (or disable the robot) to stop.
+  struct Config {
+    double ramp_rate = 1000;           // mV/s for quasistatic tests
+    double max_voltage = 7000;         // mV, quasistatic stops here
+    double step_voltage = 6000;        // mV
+    std::uint32_t step_time = 1500;    // ms
+    std::uint32_t rest_time = 1000;    // ms between tests, lets the robot stop
+  };
+
+  // One sample, velocities are wheel surface speed in m/s
+  struct Sample {
+    std::uint32_t time;    // ms since test start
+    double voltage;        // mV commanded (right side for angular tests)
+    double left;
+    double right;
+  };
+
+  // Functions
+  bool run_all(const Config &config = Config());
+  std::vector<Sample> run_test(bool angular, bool step, bool reverse, const Config &config);
+  bool save(const std::vector<Sample> &samples, const char *path);
+}
+
+#endif  // #ifndef _SYSID_H_
@@ -0,0 +1,31 @@
+// telemetry.hpp - header file for telemetry.cpp
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include "main.h"
+#include "enums.h"
+#include "odometry.hpp"
+#include "settle.hpp"
+#include "telemetry_format.h"
+
+namespace telemetry {
+  const char *const COUNTER_PATH = "/usd/telemetry_count.txt";
+  const char *const PATH_FORMAT = "/usd/telemetry_%03lu.bin";
+  const std::size_t FILE_SIZE = 4 * 1024 * 1024;    // ~7 min at ~9.4 KB/s, zero filled, writes stop there
+  const std::uint32_t KEEP = 8;                      // older telemetry files are deleted
+
+  // Functions
+  void init();
+  void new_file();
+  const char *get_path();
+  void set_odometry(std::shared_ptr<PublishedOdometry> odometry);
+  void log_mode(DRIVETRAIN_MODE drivetrain, CONTROL_MODE control, DRIVER_PROFILE driver);
+  void log_settle(const settle::Report &report);
+  std::uint32_t get_bytes();
+  bool fill_pose(PosePayload &pose);
+  void fill_motors(MotorsPayload &motors);
+  void fill_inputs(InputsPayload &inputs);
+}
+
+#endif  // #ifndef _TELEMETRY_H_
@@ -0,0 +1,158 @@
+// telemetry_format.h - binary telemetry wire format, shared by telemetry.cpp and tools/telemetry_decode.cpp
+
+#ifndef _TELEMETRY_FORMAT_H_
+#define _TELEMETRY_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Stream layout (little endian):
+//   record   := [u8 channel][varint dt_us][payload]
+//   session  := [u8 CHANNEL_SESSION]["TLM1"][u8 version][u8 channel count][channel schema...]
+//   schema   := [u8 id][u8 len][name][u8 field count]([u8 len][name][u8 type][u8 count])...
+// dt_us is the time since the previous record, the first record after a
+// session header is relative to brain startup. Payload sizes come from the
+// schema, so the decoder never needs this file to match the robot's.
+
+namespace telemetry {
+  const char MAGIC[4] = {'T', 'L', 'M', '1'};
+  const std::uint8_t VERSION = 1;
+  const std::size_t MOTOR_COUNT = 8;
+
+  enum CHANNEL_ID : std::uint8_t {CHANNEL_SESSION, CHANNEL_POSE, CHANNEL_MOTORS, CHANNEL_INPUTS, CHANNEL_MODE,
+                                  CHANNEL_BATTERY, CHANNEL_SETTLE};
+  enum FIELD_TYPE : std::uint8_t {FIELD_U8, FIELD_I8, FIELD_U16, FIELD_I16, FIELD_U32, FIELD_I32, FIELD_F32};
+
+  struct Field {
+    const char *name;
+    FIELD_TYPE type;
+    std::uint8_t count;    // > 1 for per-motor arrays
+  };
+
+  struct Channel {
+    CHANNEL_ID id;
+    const char *name;
+    const Field *fields;
+    std::uint8_t field_count;
+  };
+
+  // Payloads, field order must match the schemas below
+  struct __attribute__((packed)) PosePayload {
+    float x, y, theta;                          // m, m, rad
+    float linear_velocity, angular_velocity;    // m/s, rad/s
+  };
+
+  // Written for a reading the motor couldn't give (unplugged, PROS_ERR)
+  const std::int16_t MISSING_I16 = INT16_MIN;
+  const std::uint8_t MISSING_U8 = UINT8_MAX;
+
+  // Struct of arrays, so each column decodes as one run
+  struct __attribute__((packed)) MotorsPayload {
+    std::int16_t velocity[MOTOR_COUNT];       // rpm
+    std::int16_t current[MOTOR_COUNT];        // mA
+    std::int16_t voltage[MOTOR_COUNT];        // mV
+    std::uint8_t temperature[MOTOR_COUNT];    // C
+  };
+
+  struct __attribute__((packed)) InputsPayload {
+    std::int8_t left_x, left_y, right_x, right_y;    // raw -127..127
+    std::uint16_t buttons;                           // bit n = pros digital button 6 + n
+  };
+
+  struct __attribute__((packed)) ModePayload {
+    std::uint8_t drivetrain, control, driver;
+    std::uint8_t competition;    // pros::competition::get_status()
+  };
+
+  struct __attribute__((packed)) BatteryPayload {
+    std::uint16_t voltage;    // mV
+    std::int16_t current;     // mA
+  };
+
+  // One per settled move (see settle.cpp)
+  struct __attribute__((packed)) SettlePayload {
+    std::uint32_t move_time;      // ms from the first check to settled
+    std::uint16_t settle_time;    // ms of that inside the error band
+    std::uint16_t saved;          // ms earlier than plain SettledUtil
+    std::uint8_t flags;           // SETTLE_EARLY | SETTLE_THROUGH
+  };
+  const std::uint8_t SETTLE_EARLY = 1;
+  const std::uint8_t SETTLE_THROUGH = 2;
+
+  constexpr Field POSE_FIELDS[] = {
+    {"x", FIELD_F32, 1}, {"y", FIELD_F32, 1}, {"theta", FIELD_F32, 1},
+    {"linear_velocity", FIELD_F32, 1}, {"angular_velocity", FIELD_F32, 1},
+  };
+  constexpr Field MOTORS_FIELDS[] = {
+    {"velocity", FIELD_I16, MOTOR_COUNT}, {"current", FIELD_I16, MOTOR_COUNT},
+    {"voltage", FIELD_I16, MOTOR_COUNT}, {"temperature", FIELD_U8, MOTOR_COUNT},
+  };
+  constexpr Field INPUTS_FIELDS[] = {
+    {"left_x", FIELD_I8, 1}, {"left_y", FIELD_I8, 1}, {"right_x", FIELD_I8, 1}, {"right_y", FIELD_I8, 1},
+    {"buttons", FIELD_U16, 1},
+  };
+  constexpr Field MODE_FIELDS[] = {
+    {"drivetrain", FIELD_U8, 1}, {"control", FIELD_U8, 1}, {"driver", FIELD_U8, 1}, {"competition", FIELD_U8, 1},
+  };
+  constexpr Field BATTERY_FIELDS[] = {
+    {"voltage", FIELD_U16, 1}, {"current", FIELD_I16, 1},
+  };
+  constexpr Field SETTLE_FIELDS[] = {
+    {"move_time", FIELD_U32, 1}, {"settle_time", FIELD_U16, 1}, {"saved", FIELD_U16, 1}, {"flags", FIELD_U8, 1},
+  };
+
+  constexpr Channel CHANNELS[] = {
+    {CHANNEL_POSE, "pose", POSE_FIELDS, sizeof(POSE_FIELDS) / sizeof(Field)},
+    {CHANNEL_MOTORS, "motors", MOTORS_FIELDS, sizeof(MOTORS_FIELDS) / sizeof(Field)},
+    {CHANNEL_INPUTS, "inputs", INPUTS_FIELDS, sizeof(INPUTS_FIELDS) / sizeof(Field)},
+    {CHANNEL_MODE, "mode", MODE_FIELDS, sizeof(MODE_FIELDS) / sizeof(Field)},
+    {CHANNEL_BATTERY, "battery", BATTERY_FIELDS, sizeof(BATTERY_FIELDS) / sizeof(Field)},
+    {CHANNEL_SETTLE, "settle", SETTLE_FIELDS, sizeof(SETTLE_FIELDS) / sizeof(Field)},
+  };
+  constexpr std::size_t CHANNEL_COUNT = sizeof(CHANNELS) / sizeof(Channel);
+
+  constexpr std::size_t field_size(FIELD_TYPE type) {
+    switch (type) {
+      case FIELD_U8: case FIELD_I8: return 1;
+      case FIELD_U16: case FIELD_I16: return 2;
+      case FIELD_U32: case FIELD_I32: case FIELD_F32: return 4;
+    }
+    return 0;
+  }
+
+  constexpr std::size_t payload_size(const Field *fields, std::size_t count) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count; i++) size += field_size(fields[i].type) * fields[i].count;
+    return size;
+  }
+
+  static_assert(payload_size(POSE_FIELDS, 5) == sizeof(PosePayload), "pose schema out of date");
+  static_assert(payload_size(MOTORS_FIELDS, 4) == sizeof(MotorsPayload), "motors schema out of date");
+  static_assert(payload_size(INPUTS_FIELDS, 5) == sizeof(InputsPayload), "inputs schema out of date");
+  static_assert(payload_size(MODE_FIELDS, 4) == sizeof(ModePayload), "mode schema out of date");
+  static_assert(payload_size(BATTERY_FIELDS, 2) == sizeof(BatteryPayload), "battery schema out of date");
+  static_assert(payload_size(SETTLE_FIELDS, 4) == sizeof(SettlePayload), "settle schema out of date");
+
+  // LEB128, returns bytes written (at most 10)
+  inline std::size_t put_varint(std::uint8_t *out, std::uint64_t value) {
+    std::size_t length = 0;
+    do {
+      std::uint8_t byte = value & 0x7F;
+      value >>= 7;
+      out[length++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return length;
+  }
+
+  // Returns bytes read, 0 if the input ran out
+  inline std::size_t get_varint(const std::uint8_t *in, std::size_t available, std::uint64_t &value) {
+    value = 0;
+    for (std::size_t i = 0; i < available && i < 10; i++) {
+      value |= static_cast<std::uint64_t>(in[i] & 0x7F) << (7 * i);
+      if (!(in[i] & 0x80)) return i + 1;
+    }
+    return 0;
+  }
+}
+
+#endif  // #ifndef _TELEMETRY_FORMAT_H_
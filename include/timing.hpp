@@ -0,0 +1,13 @@
+// timing.hpp - header file for timing.cpp
+
+#ifndef _TIMING_H_
+#define _TIMING_H_
+
+#include <cstdint>
+
+namespace timing {
+  // Functions
+  std::uint64_t micros();
+}
+
+#endif  // #ifndef _TIMING_H_
@@ -0,0 +1,33 @@
+// tracking.hpp - header file for tracking.cpp
+
+#ifndef _TRACKING_H_
+#define _TRACKING_H_
+
+#include "main.h"
+#include "ports.h"
+#include "tracking_config.h"
+
+/**
+ * Read-only model over the three ADI tracking wheel encoders. Every
+ * getSensorVals() samples all three back to back, so odometry gets one
+ * consistent set of ticks per cycle. The encoders are shared by every
+ * model, each keeps its own zero.
+ */
+class TrackingWheelModel : public okapi::ReadOnlyChassisModel {
+ public:
+  TrackingWheelModel();
+
+  // {left, right, middle}, as ThreeEncoderOdometry expects
+  std::valarray<std::int32_t> getSensorVals() const override;
+
+  void reset_sensors();
+
+ protected:
+  const pros::c::adi_encoder_t *encoders;
+  std::int32_t offsets[3] = {0, 0, 0};
+};
+
+// Functions
+okapi::ChassisScales build_tracking_scales();
+
+#endif  // #ifndef _TRACKING_H_
@@ -0,0 +1,23 @@
+// tracking_config.h - contains tracking wheel #defines
+
+#ifndef _TRACKING_CONFIG_H_
+#define _TRACKING_CONFIG_H_
+
+// Set to 1 once the unpowered tracking wheels are mounted, odometry then
+// uses them instead of the drive motors' integrated encoders
+#define USE_TRACKING_WHEELS 0
+
+// Reverse flags, so forward motion counts up on left/right and right is + on middle
+#define TRACKING_LEFT_REVERSED false
+#define TRACKING_RIGHT_REVERSED true
+#define TRACKING_MIDDLE_REVERSED false
+
+// Dimensions in inches (measure these on the robot)
+#define TRACKING_WHEEL_DIAMETER 2.75      // left/right wheels
+#define TRACKING_WHEEL_TRACK 7.5          // left to right wheel contact
+#define TRACKING_MIDDLE_DISTANCE 4.0      // centre of rotation to middle wheel
+#define TRACKING_MIDDLE_DIAMETER 2.75
+
+#define TRACKING_ENCODER_TPR 360.0        // quad encoder ticks per revolution
+
+#endif  // #ifndef _TRACKING_CONFIG_H_
@@ -0,0 +1,229 @@
+#include "async_log.hpp"
+
+#include <cstring>
+
+namespace async_log {
+  const std::uint32_t LOOP_DELAY = 20;          // ms between batches
+  const std::size_t BATCH_SIZE = 1024;          // bytes written per fwrite
+  const std::size_t LINE_BUFFER = 128;          // stdio buffer on the producer FILEs
+
+  static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of two");
+
+  // Bounded MPSC ring (Vyukov style). A slot is free for position p when its
+  // sequence == p, and ready for the reader when it's p + 1.
+  struct Record {
+    std::atomic<std::uint32_t> sequence;
+    std::uint8_t sink;
+    std::uint8_t length;
+    char text[RECORD_TEXT];
+  };
+
+  Record ring[RING_SIZE];
+  std::atomic<std::uint32_t> enqueue_pos{0};
+  std::uint32_t dequeue_pos = 0;    // writer task only
+
+  std::atomic<std::uint32_t> dropped{0};
+  std::atomic<std::uint32_t> written{0};
+  std::atomic<bool> flush_requested{false};
+
+  // Output paths, registered by open() and fopen()ed by the writer
+  char sink_paths[MAX_SINKS][32];
+  const SinkOps *sink_ops[MAX_SINKS] = {};
+  bool sink_binary[MAX_SINKS] = {};    // no text notes in these
+  std::atomic<int> sink_count{0};
+  pros::Mutex sink_mutex;    // open() only, never on the logging path
+
+  pros::Task *task = nullptr;
+
+  // Claim `count` consecutive slots with one CAS, so a message split over
+  // several records can't interleave with another producer's. The reader
+  // frees slots in order, so if the last one is free they all are.
+  bool push(int sink, const char *text, std::size_t length) {
+    const std::uint32_t count = (length + RECORD_TEXT - 1) / RECORD_TEXT;
+    if (count == 0) return true;
+    if (count > RING_SIZE) {
+      dropped++;
+      return false;
+    }
+
+    std::uint32_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      const std::uint32_t last = pos + count - 1;
+      const std::uint32_t seq = ring[last & (RING_SIZE - 1)].sequence.load(std::memory_order_acquire);
+
+      if (seq == last) {
+        if (enqueue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) break;
+      }
+      else if (static_cast<std::int32_t>(seq - last) < 0) {
+        dropped++;    // full, never wait on the writer
+        return false;
+      }
+      else {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    for (std::uint32_t i = 0; i < count; i++) {
+      Record &record = ring[(pos + i) & (RING_SIZE - 1)];
+      const std::size_t chunk = std::min(length - i * RECORD_TEXT, RECORD_TEXT);
+
+      record.sink = sink;
+      record.length = chunk;
+      std::memcpy(record.text, text + i * RECORD_TEXT, chunk);
+      record.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+
+    return true;
+  }
+
+  // stdio cookie write: copy into the ring and return, whatever happens
+  ssize_t cookie_write(void *cookie, const char *buf, size_t size) {
+    push(static_cast<int>(reinterpret_cast<std::intptr_t>(cookie)), buf, size);
+    return size;
+  }
+
+  int cookie_close(void *) {
+    return 0;
+  }
+
+  void loop() {
+    FILE *files[MAX_SINKS] = {};
+    char batch[BATCH_SIZE];
+    std::size_t batch_length = 0;
+    int batch_sink = -1;
+    int text_sink = -1;    // last text sink written, gets the drop notes
+    std::uint32_t reported_drops = 0;
+    std::uint32_t last_flush = pros::millis();
+
+    auto flush = [&]() {
+      if (batch_length == 0) return;
+
+      if (sink_ops[batch_sink] != nullptr) {
+        sink_ops[batch_sink]->write(batch, batch_length);
+        batch_length = 0;
+        return;
+      }
+
+      if (files[batch_sink] == nullptr) files[batch_sink] = fopen(sink_paths[batch_sink], "a");
+      if (files[batch_sink] != nullptr) {
+        fwrite(batch, 1, batch_length, files[batch_sink]);
+        fflush(files[batch_sink]);
+      }
+
+      batch_length = 0;
+    };
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      // Drain everything ready, one fwrite per batch per sink
+      while (true) {
+        Record &record = ring[dequeue_pos & (RING_SIZE - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) break;
+
+        if (record.sink != batch_sink || batch_length + record.length > BATCH_SIZE) {
+          flush();
+          batch_sink = record.sink;
+          if (!sink_binary[batch_sink]) text_sink = batch_sink;
+        }
+
+        std::memcpy(batch + batch_length, record.text, record.length);
+        batch_length += record.length;
+        written++;
+
+        record.sequence.store(dequeue_pos + RING_SIZE, std::memory_order_release);
+        dequeue_pos++;
+      }
+
+      // Tell whoever reads the log that lines are missing. Text sinks only,
+      // a note in a binary stream would break its decoder. As a # comment
+      // so CSV sinks still parse.
+      const std::uint32_t drops = dropped.load();
+      if (drops != reported_drops && text_sink >= 0) {
+        char note[48];
+        const int length = snprintf(note, sizeof(note), "# async_log: %lu records dropped\n",
+                                    (unsigned long)(drops - reported_drops));
+        flush();
+        batch_sink = text_sink;
+        std::memcpy(batch, note, length);
+        batch_length = length;
+        reported_drops = drops;
+      }
+
+      flush();
+
+      // On request, and on a timer so an idle sink's last lines still reach the card
+      if (flush_requested.exchange(false) || now - last_flush >= FLUSH_PERIOD) {
+        for (int sink = 0; sink < sink_count; sink++) {
+          if (sink_ops[sink] != nullptr) sink_ops[sink]->flush();
+        }
+        last_flush = now;
+      }
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the writer task, open() does this if needed
+  void init() {
+    if (task != nullptr) return;
+
+    for (std::size_t i = 0; i < RING_SIZE; i++) {
+      ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    task = new pros::Task(loop, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Log writer");
+  }
+
+  // Sink id for `path` to pass to push(), -1 if there's no room for another.
+  // Binary sinks never get the writer's text notes.
+  int get_sink(const char *path, const SinkOps *ops, bool binary) {
+    init();
+
+    sink_mutex.take(TIMEOUT_MAX);
+    int sink = 0;
+    while (sink < sink_count && std::strcmp(sink_paths[sink], path) != 0) sink++;
+
+    if (sink == sink_count) {
+      if (sink_count == static_cast<int>(MAX_SINKS)) {
+        sink_mutex.give();
+        return -1;
+      }
+
+      snprintf(sink_paths[sink], sizeof(sink_paths[sink]), "%s", path);
+      sink_ops[sink] = ops;
+      sink_binary[sink] = binary;
+      sink_count++;
+    }
+    sink_mutex.give();
+
+    return sink;
+  }
+
+  // FILE that queues everything written to it for `path`. Pass it to
+  // okapi::Logger, which then only formats on the caller's thread.
+  FILE *open(const char *path, const SinkOps *ops) {
+    const int sink = get_sink(path, ops);
+    if (sink < 0) return nullptr;
+
+    cookie_io_functions_t functions = {nullptr, cookie_write, nullptr, cookie_close};
+    FILE *file = fopencookie(reinterpret_cast<void *>(static_cast<std::intptr_t>(sink)), "w", functions);
+
+    // Line buffered: each log line reaches the ring as one push
+    if (file != nullptr) setvbuf(file, nullptr, _IOLBF, LINE_BUFFER);
+    return file;
+  }
+
+  // Ask the writer to flush custom sinks after its next batch
+  void request_flush() {
+    flush_requested = true;
+  }
+
+  // Records lost because the ring was full
+  std::uint32_t get_dropped() {
+    return dropped.load();
+  }
+
+  std::uint32_t get_written() {
+    return written.load();
+  }
+}
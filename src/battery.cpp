@@ -0,0 +1,65 @@
+#include "battery.hpp"
+
+namespace battery {
+  const std::uint32_t SAMPLE_PERIOD = 100;    // ms, battery voltage moves slowly
+  const double FILTER_ALPHA = 0.1;            // ~1s time constant, rides out current spikes
+  const double MIN_SCALE = 0.85;              // don't chase a dead or misreading battery
+  const double MAX_SCALE = 1.25;
+
+  std::atomic<double> filtered{NOMINAL_VOLTAGE};
+  std::atomic<double> scale{1.0};
+  pros::Task *task = nullptr;
+
+  void loop() {
+    okapi::EmaFilter filter(FILTER_ALPHA);
+    filter.filter(NOMINAL_VOLTAGE);    // start from nominal, not 0
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      std::int32_t reading = pros::battery::get_voltage();
+
+      // PROS_ERR or nonsense, keep the last value
+      if (reading > 5000 && reading < 16000) {
+        double voltage = filter.filter(reading);
+        filtered = voltage;
+        scale = std::clamp(NOMINAL_VOLTAGE / voltage, MIN_SCALE, MAX_SCALE);
+      }
+
+      pros::Task::delay_until(&now, SAMPLE_PERIOD);
+    }
+  }
+
+  // Start the sampling task, call once from initialize()
+  void init() {
+    if (task != nullptr) return;
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Battery");
+  }
+
+  // Filtered battery voltage in mV
+  double get_voltage() {
+    return filtered.load();
+  }
+
+  // Multiply voltage commands by this to get nominal-battery behaviour
+  double get_scale() {
+    return scale.load();
+  }
+
+  // Scale a voltage command (mV) to nominal and clamp it to the motor range
+  double compensate(double voltage) {
+    return std::clamp(voltage * get_scale(), -12000.0, 12000.0);
+  }
+
+  // Integrated (motor firmware) velocity and position moves already regulate
+  // speed against the battery, until the target is more than a low battery
+  // can reach. Targets pass through untouched down to MIN_RUN_VOLTAGE, below
+  // that they're capped in proportion to the filtered voltage so the motors
+  // track a slower profile instead of saturating.
+  double limit_velocity(double rpm, double max_rpm) {
+    const double voltage = get_voltage();
+    if (voltage >= MIN_RUN_VOLTAGE) return rpm;
+
+    const double reachable = max_rpm * voltage / MIN_RUN_VOLTAGE;
+    return std::clamp(rpm, -reachable, reachable);
+  }
+}
@@ -0,0 +1,155 @@
+#include "block_file.hpp"
+
+#include <cstring>
+
+BlockFile::BlockFile(const char *icounterPath, const char *ipathFormat, std::size_t ifileSize, std::uint32_t ikeep)
+  : counter_path(icounterPath), path_format(ipathFormat), file_size(ifileSize), keep(ikeep) {}
+
+// Next file number from the counter file, written back straight away
+std::uint32_t BlockFile::next_number() {
+  unsigned long last = 0;
+
+  FILE *counter = fopen(counter_path, "r");
+  if (counter != nullptr) {
+    if (fscanf(counter, "%lu", &last) != 1) last = 0;
+    fclose(counter);
+  }
+
+  counter = fopen(counter_path, "w");
+  if (counter != nullptr) {
+    fprintf(counter, "%lu\n", last + 1);
+    fclose(counter);
+  }
+
+  return last + 1;
+}
+
+// Allocate every cluster now. Zeros mark the unused tail.
+bool BlockFile::preallocate(const char *ipath) {
+  static const char zeros[4096] = {};
+
+  FILE *out = fopen(ipath, "w");
+  if (out == nullptr) return false;
+
+  for (std::size_t written = 0; written < file_size; written += sizeof(zeros)) {
+    if (fwrite(zeros, 1, sizeof(zeros), out) != sizeof(zeros)) {
+      fclose(out);
+      return false;
+    }
+  }
+
+  fclose(out);
+  return true;
+}
+
+// Number and preallocate a new file, dropping the oldest. Nothing is written
+// to it until begin().
+bool BlockFile::prepare() {
+  number = next_number();
+  snprintf(path, sizeof(path), path_format, (unsigned long)number);
+
+  if (number > keep) {
+    char old[32];
+    snprintf(old, sizeof(old), path_format, (unsigned long)(number - keep));
+    remove(old);
+  }
+
+  if (!preallocate(path)) return false;
+
+  if (prepared != nullptr) fclose(prepared);
+  prepared = fopen(path, "r+");
+  if (prepared == nullptr) return false;
+  setvbuf(prepared, nullptr, _IONBF, 0);    // we only write whole blocks
+  return true;
+}
+
+// Hand the prepared file to the writer, which switches to it once the stream
+// reaches byte `iswitchAt` (0: right away), so a binary stream can start the
+// new file on a record boundary
+void BlockFile::begin(std::uint32_t iswitchAt) {
+  if (prepared == nullptr) return;
+
+  // The writer never saw a file still waiting here, so it's ours to close
+  switch_at.store(iswitchAt, std::memory_order_relaxed);
+  FILE *unused = next_file.exchange(prepared);
+  if (unused != nullptr) fclose(unused);
+  prepared = nullptr;
+}
+
+// Write the current block at its aligned offset. A partial block is written
+// padded with zeros and stays in the buffer, to be rewritten once it fills.
+void BlockFile::write_block() {
+  std::memset(block + block_length, 0, BLOCK_SIZE - block_length);
+  fseek(file, block_offset, SEEK_SET);
+  fwrite(block, 1, BLOCK_SIZE, file);
+  fflush(file);
+
+  if (block_length == BLOCK_SIZE) {
+    block_offset += BLOCK_SIZE;
+    block_length = 0;
+  }
+}
+
+// Finish the old file's last block and move to the queued one
+void BlockFile::take_next_file() {
+  FILE *next = next_file.exchange(nullptr);
+  if (next == nullptr) return;
+
+  if (file != nullptr) {
+    if (block_length > 0) write_block();
+    fclose(file);
+  }
+
+  file = next;
+  block_length = 0;
+  block_offset = 0;
+}
+
+void BlockFile::write(const char *data, std::size_t length) {
+  while (length > 0) {
+    // Split the data where the queued file takes over
+    std::size_t chunk = length;
+    if (next_file.load(std::memory_order_acquire) != nullptr) {
+      const std::int32_t until = static_cast<std::int32_t>(switch_at.load(std::memory_order_relaxed) - received);
+      if (until <= 0) take_next_file();
+      else chunk = std::min<std::size_t>(chunk, until);
+    }
+
+    chunk = std::min(chunk, BLOCK_SIZE - block_length);
+    received += chunk;
+
+    if (file != nullptr && block_offset >= file_size) {
+      printf("block_file: %s is full, dropping the rest\n", path);
+      fclose(file);
+      file = nullptr;
+    }
+
+    if (file != nullptr) {
+      std::memcpy(block + block_length, data, chunk);
+      block_length += chunk;
+      if (block_length == BLOCK_SIZE) write_block();
+    }
+
+    data += chunk;
+    length -= chunk;
+  }
+}
+
+// Partial block out to the card, the file size is already final. Called by
+// the writer at least every async_log::FLUSH_PERIOD.
+void BlockFile::flush() {
+  if (next_file.load(std::memory_order_acquire) != nullptr &&
+      static_cast<std::int32_t>(switch_at.load(std::memory_order_relaxed) - received) <= 0) {
+    take_next_file();
+  }
+
+  if (file != nullptr && block_length > 0) write_block();
+}
+
+std::uint32_t BlockFile::get_number() const {
+  return number;
+}
+
+const char *BlockFile::get_path() const {
+  return path;
+}
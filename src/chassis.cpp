@@ -1,22 +1,217 @@
 #include "chassis.hpp"
 
+// Set to 1 (or EXTRA_CXXFLAGS=-DUSE_SCHEDULED_PID=1) to drive auton moves
+// with ChassisControllerPID + the gain schedules below instead of the
+// motors' integrated position control
+#ifndef USE_SCHEDULED_PID
+#define USE_SCHEDULED_PID 0
+#endif
+
+#if USE_SCHEDULED_PID
+// Gain schedules, keyed by move size. Starting points, tune on the robot.
+// Gains are per encoder tick of error (distance) / per tick of turn.
+const std::vector<std::pair<okapi::QLength, okapi::IterativePosPIDController::Gains>> DISTANCE_GAINS = {
+  {6_in, {0.0025, 0, 0.00008}},
+  {24_in, {0.0018, 0, 0.00006}},
+  {48_in, {0.0012, 0, 0.00005}}
+};
+
+const std::vector<std::pair<okapi::QAngle, okapi::IterativePosPIDController::Gains>> TURN_GAINS = {
+  {15_deg, {0.0040, 0.0001, 0.00008}},    // micro-turns: stiff, with a little I to finish
+  {90_deg, {0.0025, 0, 0.00007}},
+  {180_deg, {0.0018, 0, 0.00006}}
+};
+
+// Multipliers keyed by speed (fraction of top speed): push harder when slow,
+// damp harder when fast
+const std::vector<GainRow> VELOCITY_MULTIPLIERS = {
+  {0.0, 1.2, 1.0, 0.8},
+  {0.5, 1.0, 1.0, 1.0},
+  {1.0, 0.9, 1.0, 1.3}
+};
+
+// Heading hold while driving straight
+const okapi::IterativePosPIDController::Gains ANGLE_GAINS = {0.001, 0, 0.0001};
+
+// Build a schedule in encoder ticks from the tables above
+template <typename Q>
+std::shared_ptr<const GainSchedule> build_schedule(const std::vector<std::pair<Q, okapi::IterativePosPIDController::Gains>> &table,
+                                                   double ticks_per_unit, Q unit, double max_velocity) {
+  std::vector<GainRow> rows;
+  for (const auto &row : table) {
+    rows.push_back({row.first.convert(unit) * ticks_per_unit, row.second.kP, row.second.kI, row.second.kD});
+  }
+
+  return std::make_shared<const GainSchedule>(rows, VELOCITY_MULTIPLIERS, max_velocity);
+}
+#endif
+
 std::shared_ptr<okapi::OdomChassisController> build_chassis_controller() {
   using namespace okapi;    // simplifies things
 
-  std::shared_ptr<OdomChassisController> cc = ChassisControllerBuilder()
-    // Right motors reversed
-    .withMotors(
-      {LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT},
-      {-RIGHT_FRONT_MOTOR_PORT, -RIGHT_BACK_MOTOR_PORT}
-    )
-    // Green gears + 3.25" wheel ⌀, 10.0" wheel track
-    .withDimensions(AbstractMotor::gearset::green, {{3.25_in, 10_in}, imev5GreenTPR})
-    // Enable odometry
-    .withOdometry(StateMode::CARTESIAN)
-    .buildOdometry();
+  // Right motors reversed
+  std::shared_ptr<MotorGroup> left = std::make_shared<MotorGroup>(
+    std::initializer_list<Motor>{LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT}
+  );
+  std::shared_ptr<MotorGroup> right = std::make_shared<MotorGroup>(
+    std::initializer_list<Motor>{-RIGHT_FRONT_MOTOR_PORT, -RIGHT_BACK_MOTOR_PORT}
+  );
+
+  // Green gears + 3.25" wheel ⌀, 10.0" wheel track
+  const ChassisScales scales({3.25_in, 10_in}, imev5GreenTPR);
+
+  // Built by hand since the builder can't take custom PID controllers or
+  // settled utils
+  std::shared_ptr<SkidSteerModel> model = std::make_shared<SkidSteerModel>(
+    left, right, left->getEncoder(), right->getEncoder(), 200, 12000
+  );
+  model->setGearing(AbstractMotor::gearset::green);
+  model->setEncoderUnits(AbstractMotor::encoderUnits::counts);
+
+  // Odometry publishes its state lock-free so getState() never contends with
+  // the odometry task
+#if USE_TRACKING_WHEELS
+  // Unpowered tracking wheels don't slip under acceleration like the drive does
+  std::shared_ptr<TrackingWheelModel> odom_model = std::make_shared<TrackingWheelModel>();
+  odom_model->reset_sensors();
+  std::shared_ptr<PublishedOdometry> odom = std::make_shared<PublishedOdometry>(
+    std::make_shared<ThreeEncoderOdometry>(TimeUtilFactory::createDefault(), odom_model, build_tracking_scales())
+  );
+#else
+  // Reads the drive motors' integrated encoders
+  std::shared_ptr<PublishedOdometry> odom = std::make_shared<PublishedOdometry>(
+    std::make_shared<TwoEncoderOdometry>(TimeUtilFactory::createDefault(), model, scales)
+  );
+#endif
+
+  // Don't integrate wheel motion that the IMU says didn't happen
+  odom->set_freeze_when(slip::should_freeze_odometry);
+
+  // Moves finish as soon as the drive has provably stopped in tolerance;
+  // only the left side reports so each move is counted once
+  settle::Config left_settle;
+  settle::Config right_settle;
+  right_settle.report = false;
+  TimeUtil left_time = settle::build_time_util([left]() { return left->getActualVelocity(); }, left_settle);
+  TimeUtil right_time = settle::build_time_util([right]() { return right->getActualVelocity(); }, right_settle);
+
+#if USE_SCHEDULED_PID
+  // Top speed in ticks/s for the velocity multipliers
+  const double max_ticks_per_second = 200.0 / 60.0 * imev5GreenTPR;
+
+  // Both sides are in the PID readings, so either velocity works for settling
+  std::shared_ptr<ChassisControllerPID> controller = std::make_shared<ChassisControllerPID>(
+    TimeUtilFactory::createDefault(), model,
+    std::make_unique<ScheduledPIDController>(
+      build_schedule(DISTANCE_GAINS, scales.straight, meter, max_ticks_per_second), left_time),
+    std::make_unique<ScheduledPIDController>(
+      build_schedule(TURN_GAINS, scales.turn, degree, max_ticks_per_second), left_time),
+    std::make_unique<IterativePosPIDController>(ANGLE_GAINS, TimeUtilFactory::createDefault()),
+    AbstractMotor::gearset::green, scales
+  );
+  controller->setVelocityMode(false);    // voltage output, so battery scaling in the schedule applies
+  controller->startThread();
+
+  // Stop with the task that built us, like the builder does
+  controller->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+#else
+  std::shared_ptr<ChassisControllerIntegrated> controller = std::make_shared<ChassisControllerIntegrated>(
+    TimeUtilFactory::createDefault(), model,
+    std::make_unique<AsyncPosIntegratedController>(left, AbstractMotor::gearset::green, 200, left_time),
+    std::make_unique<AsyncPosIntegratedController>(right, AbstractMotor::gearset::green, 200, right_time),
+    AbstractMotor::gearset::green, scales
+  );
+#endif
+
+  std::shared_ptr<DefaultOdomChassisController> cc = std::make_shared<DefaultOdomChassisController>(
+    TimeUtilFactory::createDefault(), odom, controller, StateMode::CARTESIAN
+  );
+  cc->startOdomThread();
+  cc->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
 
   // Reset odom state
   cc->setState({0_in, 0_in, 0_deg});
 
   return cc;
 }
+
+// Velocity-controlled drive model for driver control and motion profiles,
+// shares the drive ports with the chassis controller
+std::shared_ptr<FeedforwardDriveModel> build_drive_model() {
+  using namespace okapi;    // simplifies things
+
+  std::shared_ptr<MotorGroup> left = std::make_shared<MotorGroup>(
+    std::initializer_list<Motor>{LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT}
+  );
+  std::shared_ptr<MotorGroup> right = std::make_shared<MotorGroup>(
+    std::initializer_list<Motor>{-RIGHT_FRONT_MOTOR_PORT, -RIGHT_BACK_MOTOR_PORT}
+  );
+
+  return std::make_shared<FeedforwardDriveModel>(
+    left, right, 3.25_in,
+    Feedforward{DRIVE_LINEAR_KS, DRIVE_LINEAR_KV, DRIVE_LINEAR_KA},
+    Feedforward{DRIVE_ANGULAR_KS, DRIVE_ANGULAR_KV, DRIVE_ANGULAR_KA},
+    DRIVE_VELOCITY_KP, DRIVE_MAX_ACCEL,
+    200    // green cartridge rpm
+  );
+}
+
+// The odometry built above, for reading velocity + timestamp too
+std::shared_ptr<PublishedOdometry> get_published_odometry(const std::shared_ptr<okapi::OdomChassisController> &cc) {
+  return std::static_pointer_cast<PublishedOdometry>(cc->getOdometry());
+}
+
+// Drive until settled or until the slip detector reports wall contact (stall or
+// collision), whichever is first. Returns true if it ended on contact.
+bool move_until_contact(const std::shared_ptr<okapi::OdomChassisController> &cc, okapi::QLength distance, std::uint32_t timeout) {
+  const std::uint32_t contacts = slip::get_contact_count();
+  const std::uint32_t start = pros::millis();
+
+  cc->moveDistanceAsync(distance);
+
+  while (!cc->isSettled()) {
+    if (slip::get_contact_count() != contacts) {
+      cc->stop();
+      return true;
+    }
+
+    if (pros::millis() - start > timeout) {
+      cc->stop();
+      return false;
+    }
+
+    pros::delay(10);
+  }
+
+  return false;
+}
+
+// Drive `distance` and return as soon as both sides are within `through` of
+// their targets, still rolling, so the next move starts without stopping.
+// Polls isSettled() instead of waitUntilSettled(), which would brake. A
+// zero `through` is a plain moveDistance(). Returns false on timeout.
+bool move_through(const std::shared_ptr<okapi::OdomChassisController> &cc, okapi::QLength distance,
+                  okapi::QLength through, std::uint32_t timeout) {
+  if (through.convert(okapi::meter) <= 0) {
+    cc->moveDistance(distance);
+    return true;
+  }
+
+  const std::uint32_t start = pros::millis();
+
+  // Settled utils work in motor ticks
+  settle::settle_through(through.convert(okapi::meter) * cc->getChassisScales().straight);
+  cc->moveDistanceAsync(distance);
+
+  while (!cc->isSettled()) {
+    if (pros::millis() - start > timeout) {
+      settle::settle_through(0);
+      cc->waitUntilSettled();
+      return false;
+    }
+
+    pros::delay(10);
+  }
+
+  return true;
+}
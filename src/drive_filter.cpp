@@ -0,0 +1,108 @@
+#include "drive_filter.hpp"
+
+// Default profiles: slow mode is for lining up, so it's allowed to react faster
+// relative to its (much lower) top speed. Stick deadbands live in the
+// response curves (joystick.cpp), so none here.
+const SlewProfile FAST_PROFILE = {3.0, 6.0, 5.0, 10.0, 0, 1.0, 0.1};
+const SlewProfile SLOW_PROFILE = {4.0, 8.0, 6.0, 12.0, 0, 0.6, 0.025};
+
+const double MAX_DT = 0.05;    // s, don't jump after a long gap (auton run from opcontrol)
+
+// Move current toward target, at most accel/decel per second. Anything that
+// shrinks the magnitude or crosses 0 counts as decelerating.
+double slew(double current, double target, double accel, double decel, double dt) {
+  const bool speeding_up = std::abs(target) > std::abs(current) && (current == 0 || (target > 0) == (current > 0));
+  const double step = (speeding_up ? accel : decel) * dt;
+
+  // Reversals stop at 0 for this tick
+  if (current != 0 && (target > 0) != (current > 0) && target != 0) {
+    return current > 0 ? std::max(current - step, 0.0) : std::min(current + step, 0.0);
+  }
+
+  return std::clamp(target, current - step, current + step);
+}
+
+double apply_deadband(double value, double deadband) {
+  return std::abs(value) <= deadband ? 0 : value;
+}
+
+DriveFilter::DriveFilter() {
+  profiles[FAST] = FAST_PROFILE;
+  profiles[SLOW] = SLOW_PROFILE;
+}
+
+DriveCommand DriveFilter::arcade(double forward, double yaw, DRIVETRAIN_MODE mode, std::uint32_t now) {
+  const SlewProfile &profile = profiles[mode];
+
+  forward = apply_deadband(std::clamp(forward, -1.0, 1.0), profile.deadband);
+  yaw = apply_deadband(std::clamp(yaw, -1.0, 1.0), profile.deadband);
+
+  return filter(forward, yaw, profile, now);
+}
+
+// Tank sticks are converted to forward/turn so both get their own limits
+DriveCommand DriveFilter::tank(double left, double right, DRIVETRAIN_MODE mode, std::uint32_t now) {
+  const SlewProfile &profile = profiles[mode];
+
+  left = apply_deadband(std::clamp(left, -1.0, 1.0), profile.deadband);
+  right = apply_deadband(std::clamp(right, -1.0, 1.0), profile.deadband);
+
+  return filter((left + right) / 2.0, (left - right) / 2.0, profile, now);
+}
+
+// Curve sets path curvature, not turn rate, so the robot arcs the same way
+// at any speed. Near 0 throttle it falls back to turning in place.
+DriveCommand DriveFilter::curvature(double throttle, double curve, DRIVETRAIN_MODE mode, std::uint32_t now) {
+  const SlewProfile &profile = profiles[mode];
+
+  throttle = apply_deadband(std::clamp(throttle, -1.0, 1.0), profile.deadband);
+  curve = apply_deadband(std::clamp(curve, -1.0, 1.0), profile.deadband);
+
+  const double yaw = std::abs(throttle) < profile.quick_turn ? curve : std::abs(throttle) * curve * profile.turn_sensitivity;
+  return filter(throttle, yaw, profile, now);
+}
+
+void DriveFilter::set_profile(DRIVETRAIN_MODE mode, const SlewProfile &profile) {
+  profiles[mode] = profile;
+}
+
+const SlewProfile &DriveFilter::get_profile(DRIVETRAIN_MODE mode) const {
+  return profiles[mode];
+}
+
+void DriveFilter::reset() {
+  forward_out = 0;
+  turn_out = 0;
+  last_time = 0;
+}
+
+// Slew limit forward and turn, then mix
+DriveCommand DriveFilter::filter(double forward, double turn, const SlewProfile &profile, std::uint32_t now) {
+  const double step = dt(now);
+
+  forward_out = slew(forward_out, forward, profile.forward_accel, profile.forward_decel, step);
+  turn_out = slew(turn_out, turn, profile.turn_accel, profile.turn_decel, step);
+
+  return mix(forward_out, turn_out);
+}
+
+// Seconds since the last call, clamped
+double DriveFilter::dt(std::uint32_t now) {
+  const double step = last_time == 0 ? 0 : std::min((now - last_time) / 1000.0, MAX_DT);
+  last_time = now;
+  return step;
+}
+
+// Same mixing as SkidSteerModel::arcade()
+DriveCommand DriveFilter::mix(double forward, double turn) const {
+  double left = forward + turn;
+  double right = forward - turn;
+
+  const double max_input = std::max(std::abs(left), std::abs(right));
+  if (max_input > 1) {
+    left /= max_input;
+    right /= max_input;
+  }
+
+  return {left, right};
+}
@@ -0,0 +1,134 @@
+#include "feedforward.hpp"
+#include "battery.hpp"
+
+using namespace okapi;    // simplifies things
+
+double Feedforward::calculate(double velocity, double acceleration) const {
+  double sign = velocity > 0 ? 1 : velocity < 0 ? -1 : 0;
+  return kS * sign + kV * velocity + kA * acceleration;
+}
+
+FeedforwardDriveModel::FeedforwardDriveModel(std::shared_ptr<AbstractMotor> ileftSideMotor,
+                                             std::shared_ptr<AbstractMotor> irightSideMotor,
+                                             QLength iwheelDiameter,
+                                             const Feedforward &ilinear,
+                                             const Feedforward &iangular,
+                                             double ikP,
+                                             double imaxAccel,
+                                             double imaxVelocity,
+                                             double imaxVoltage)
+  : SkidSteerModel(ileftSideMotor, irightSideMotor, ileftSideMotor->getEncoder(),
+                   irightSideMotor->getEncoder(), imaxVelocity, imaxVoltage),
+    wheel_circumference(iwheelDiameter.convert(meter) * pi),
+    linear(ilinear),
+    angular(iangular),
+    kP(ikP),
+    max_accel(imaxAccel) {}
+
+void FeedforwardDriveModel::forward(double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * max_speed();
+  set_velocity(speed, speed);
+}
+
+void FeedforwardDriveModel::driveVector(double iforwardSpeed, double iyaw) {
+  arcade(iforwardSpeed, iyaw);
+}
+
+void FeedforwardDriveModel::rotate(double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * max_speed();
+  set_velocity(speed, -speed);
+}
+
+void FeedforwardDriveModel::stop() {
+  last_left = 0;
+  last_right = 0;
+  last_time = 0;
+  SkidSteerModel::stop();
+}
+
+void FeedforwardDriveModel::tank(double ileftSpeed, double irightSpeed, double ithreshold) {
+  double left_speed = std::clamp(ileftSpeed, -1.0, 1.0);
+  double right_speed = std::clamp(irightSpeed, -1.0, 1.0);
+
+  if (std::abs(left_speed) < ithreshold) left_speed = 0;
+  if (std::abs(right_speed) < ithreshold) right_speed = 0;
+
+  set_velocity(left_speed * max_speed(), right_speed * max_speed());
+}
+
+// Same mixing as SkidSteerModel::arcade(), but into velocity targets
+void FeedforwardDriveModel::arcade(double iforwardSpeed, double iyaw, double ithreshold) {
+  double forward_speed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  double yaw = std::clamp(iyaw, -1.0, 1.0);
+
+  if (std::abs(forward_speed) <= ithreshold) forward_speed = 0;
+  if (std::abs(yaw) <= ithreshold) yaw = 0;
+
+  double left_speed = forward_speed + yaw;
+  double right_speed = forward_speed - yaw;
+  const double max_input = std::max(std::abs(left_speed), std::abs(right_speed));
+  if (max_input > 1) {
+    left_speed /= max_input;
+    right_speed /= max_input;
+  }
+
+  set_velocity(left_speed * max_speed(), right_speed * max_speed());
+}
+
+// Profiles drive one side at a time, keep the other side's target
+void FeedforwardDriveModel::left(double ispeed) {
+  set_velocity(std::clamp(ispeed, -1.0, 1.0) * max_speed(), last_right);
+}
+
+void FeedforwardDriveModel::right(double ispeed) {
+  set_velocity(last_left, std::clamp(ispeed, -1.0, 1.0) * max_speed());
+}
+
+void FeedforwardDriveModel::set_velocity(double left_velocity, double right_velocity) {
+  const std::uint32_t now = pros::millis();
+  const double dt = (now - last_time) / 1000.0;
+
+  // Requested acceleration, none if we haven't been called recently
+  double left_accel = 0;
+  double right_accel = 0;
+  if (last_time != 0 && dt > 0 && dt < 0.05) {
+    left_accel = std::clamp((left_velocity - last_left) / dt, -max_accel, max_accel);
+    right_accel = std::clamp((right_velocity - last_right) / dt, -max_accel, max_accel);
+  }
+
+  last_left = left_velocity;
+  last_right = right_velocity;
+  last_time = now;
+
+  // Let the motors' brake mode hold the robot instead of fighting with kP
+  if (left_velocity == 0 && right_velocity == 0) {
+    leftSideMotor->moveVelocity(0);
+    rightSideMotor->moveVelocity(0);
+    return;
+  }
+
+  // Linear part is the average, angular part is each side's share of the turn
+  const double velocity = (left_velocity + right_velocity) / 2.0;
+  const double accel = (left_accel + right_accel) / 2.0;
+  const double turn_velocity = (right_velocity - left_velocity) / 2.0;
+  const double turn_accel = (right_accel - left_accel) / 2.0;
+
+  const double base = linear.calculate(velocity, accel);
+  const double turn = angular.calculate(turn_velocity, turn_accel);
+
+  // Constants were characterized at nominal battery, so scale to match
+  const double left_voltage = battery::compensate(base - turn + kP * (left_velocity - measured_speed(leftSideMotor)));
+  const double right_voltage = battery::compensate(base + turn + kP * (right_velocity - measured_speed(rightSideMotor)));
+
+  leftSideMotor->moveVoltage(static_cast<std::int16_t>(std::clamp(left_voltage, -maxVoltage, maxVoltage)));
+  rightSideMotor->moveVoltage(static_cast<std::int16_t>(std::clamp(right_voltage, -maxVoltage, maxVoltage)));
+}
+
+// Top wheel speed in m/s allowed by setMaxVelocity()
+double FeedforwardDriveModel::max_speed() const {
+  return maxVelocity / 60.0 * wheel_circumference;
+}
+
+double FeedforwardDriveModel::measured_speed(const std::shared_ptr<AbstractMotor> &motor) const {
+  return motor->getActualVelocity() / 60.0 * wheel_circumference;
+}
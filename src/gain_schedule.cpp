@@ -0,0 +1,82 @@
+#include "gain_schedule.hpp"
+#include "battery.hpp"
+
+using namespace okapi;    // simplifies things
+
+GainSchedule::GainSchedule(std::vector<GainRow> itargetRows, std::vector<GainRow> ivelocityRows, double imaxVelocity)
+  : target_rows(std::move(itargetRows)),
+    velocity_rows(std::move(ivelocityRows)),
+    max_velocity(imaxVelocity) {
+  auto by_key = [](const GainRow &a, const GainRow &b) { return a.key < b.key; };
+  std::sort(target_rows.begin(), target_rows.end(), by_key);
+  std::sort(velocity_rows.begin(), velocity_rows.end(), by_key);
+}
+
+IterativePosPIDController::Gains GainSchedule::lookup(double target, double velocity, double battery_scale) const {
+  const GainRow base = interpolate(target_rows, std::abs(target));
+
+  // No velocity table means no adjustment
+  GainRow multiplier{0, 1, 1, 1};
+  if (!velocity_rows.empty() && max_velocity > 0) {
+    multiplier = interpolate(velocity_rows, std::abs(velocity) / max_velocity);
+  }
+
+  return {
+    base.kP * multiplier.kP * battery_scale,
+    base.kI * multiplier.kI * battery_scale,
+    base.kD * multiplier.kD * battery_scale,
+    0
+  };
+}
+
+// Linear interpolation between rows, clamped to the first/last row
+GainRow GainSchedule::interpolate(const std::vector<GainRow> &rows, double key) {
+  if (rows.empty()) return {key, 0, 0, 0};
+  if (key <= rows.front().key) return rows.front();
+  if (key >= rows.back().key) return rows.back();
+
+  std::size_t i = 1;
+  while (rows[i].key < key) i++;
+
+  const GainRow &lo = rows[i - 1];
+  const GainRow &hi = rows[i];
+  const double t = (key - lo.key) / (hi.key - lo.key);
+
+  return {
+    key,
+    lo.kP + (hi.kP - lo.kP) * t,
+    lo.kI + (hi.kI - lo.kI) * t,
+    lo.kD + (hi.kD - lo.kD) * t
+  };
+}
+
+ScheduledPIDController::ScheduledPIDController(std::shared_ptr<const GainSchedule> ischedule,
+                                               const TimeUtil &itimeUtil,
+                                               std::shared_ptr<Logger> ilogger)
+  : IterativePosPIDController(ischedule->lookup(0, 0, 1), itimeUtil,
+                              std::make_unique<PassthroughFilter>(), std::move(ilogger)),
+    schedule(std::move(ischedule)) {}
+
+double ScheduledPIDController::step(double inewReading) {
+  const std::uint32_t now = pros::millis();
+  const double dt = (now - last_time) / 1000.0;
+  const double velocity = (last_time != 0 && dt > 0) ? (inewReading - last_reading) / dt : 0;
+
+  last_reading = inewReading;
+  last_time = now;
+
+  setGains(schedule->lookup(move_size, velocity, battery::get_scale()));
+  return IterativePosPIDController::step(inewReading);
+}
+
+// ChassisControllerPID zeroes the sensors before each move, so the target
+// is the move size
+void ScheduledPIDController::setTarget(double itarget) {
+  move_size = std::abs(itarget);
+  IterativePosPIDController::setTarget(itarget);
+}
+
+void ScheduledPIDController::reset() {
+  last_time = 0;
+  IterativePosPIDController::reset();
+}
@@ -0,0 +1,58 @@
+#include "heading_hold.hpp"
+
+const double ENGAGE_FORWARD = 0.05;        // only hold while actually driving
+const double STILL_RATE = 20;              // deg/s, turn has finished below this
+const std::uint32_t STILL_TIME = 60;       // ms below STILL_RATE before locking
+
+HeadingHold::HeadingHold(double ikP, double ikI, double ikD, double imaxCorrection)
+  : pid(ikP, ikI, ikD, 0, okapi::TimeUtilFactory::createDefault()) {
+  pid.setOutputLimits(imaxCorrection, -imaxCorrection);
+}
+
+double HeadingHold::step(double forward, double yaw, double heading, std::uint32_t now) {
+  // IMU unplugged or still calibrating
+  if (!std::isfinite(heading)) {
+    release();
+    return yaw;
+  }
+
+  const double dt = last_time == 0 ? 0 : (now - last_time) / 1000.0;
+  const double rate = dt > 0 ? std::abs(heading - last_heading) / dt : 0;
+  last_heading = heading;
+  last_time = now;
+
+  // Driver is steering (or stopped), hand control straight back
+  if (yaw != 0 || std::abs(forward) < ENGAGE_FORWARD) {
+    release();
+    return yaw;
+  }
+
+  if (!holding) {
+    if (rate > STILL_RATE) {
+      still_since = 0;
+      return yaw;
+    }
+    if (still_since == 0) still_since = now;
+    if (now - still_since < STILL_TIME) return yaw;
+
+    pid.reset();
+    pid.setTarget(heading);
+    holding = true;
+  }
+
+  return pid.step(heading);
+}
+
+void HeadingHold::set_gains(double ikP, double ikI, double ikD, double imaxCorrection) {
+  pid.setGains({ikP, ikI, ikD, 0});
+  pid.setOutputLimits(imaxCorrection, -imaxCorrection);
+}
+
+bool HeadingHold::is_holding() const {
+  return holding;
+}
+
+void HeadingHold::release() {
+  holding = false;
+  still_since = 0;
+}
@@ -0,0 +1,256 @@
+#include "heap.hpp"
+#include "logging.hpp"
+
+#include <malloc.h>
+#include <unistd.h>
+#include <cstring>
+
+// newlib's allocator (dlmalloc 2.6, mallocr.c), read by find_largest_block()
+extern "C" {
+  extern void *__malloc_av_[];         // bin list heads, see bin_at() in mallocr.c
+  extern struct _reent *_impure_ptr;
+  extern char _heap_end;               // v5-common.ld
+  void __malloc_lock(struct _reent *r);
+  void __malloc_unlock(struct _reent *r);
+}
+
+namespace heap {
+  const std::size_t MAX_SECTIONS = 8;    // tasks inside a NoAllocSection at once
+  const std::size_t BIN_COUNT = 128;     // NAV in mallocr.c
+  const std::size_t SIZE_BITS = 0x3;     // PREV_INUSE | IS_MMAPPED in a chunk's size
+  const std::size_t PAGE_SIZE = 4096;    // sbrk rounding when malloc grows the top chunk
+
+  // mallocr.c chunk header, fd/bk are only valid while the chunk is free
+  struct Chunk {
+    std::size_t prev_size;
+    std::size_t size;
+    Chunk *fd;
+    Chunk *bk;
+  };
+
+  std::atomic<int> current_mode{MODE_INITIALIZE};
+
+#if HEAP_INSTRUMENT
+  std::atomic<std::size_t> used{0};
+  std::atomic<std::size_t> peak{0};
+  std::atomic<std::uint32_t> allocs[MODE_COUNT];
+  std::atomic<std::uint32_t> frees[MODE_COUNT];
+  std::atomic<std::uint32_t> violations{0};
+
+  // Tasks currently inside a NoAllocSection, with their section names
+  std::atomic<pros::task_t> section_tasks[MAX_SECTIONS];
+  const char *section_names[MAX_SECTIONS];
+
+  void record_alloc(std::size_t size) {
+    const std::size_t now_used = used.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t old_peak = peak.load(std::memory_order_relaxed);
+    while (now_used > old_peak && !peak.compare_exchange_weak(old_peak, now_used, std::memory_order_relaxed)) {}
+    allocs[current_mode.load(std::memory_order_relaxed)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void record_free(std::size_t size) {
+    used.fetch_sub(size, std::memory_order_relaxed);
+    frees[current_mode.load(std::memory_order_relaxed)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Called from inside malloc, so nothing here may allocate. The abort
+  // message goes straight to the serial driver with write().
+  void check_section() {
+    const pros::task_t self = pros::c::task_get_current();
+    for (std::size_t i = 0; i < MAX_SECTIONS; i++) {
+      if (section_tasks[i].load(std::memory_order_relaxed) != self) continue;
+
+      violations.fetch_add(1, std::memory_order_relaxed);
+#if HEAP_FAIL_ON_ALLOC
+      static const char message[] = "heap: allocation inside no-alloc section ";
+      write(2, message, sizeof(message) - 1);
+      write(2, section_names[i], std::strlen(section_names[i]));
+      write(2, "\n", 1);
+      std::abort();
+#endif
+      return;
+    }
+  }
+
+  NoAllocSection::NoAllocSection(const char *iname) : slot(-1) {
+    const pros::task_t self = pros::c::task_get_current();
+    for (std::size_t i = 0; i < MAX_SECTIONS; i++) {
+      pros::task_t expected = nullptr;
+      if (section_tasks[i].compare_exchange_strong(expected, self)) {
+        section_names[i] = iname;
+        slot = i;
+        return;
+      }
+      if (expected == self) return;    // nested, the outer section covers it
+    }
+  }
+
+  NoAllocSection::~NoAllocSection() {
+    if (slot >= 0) section_tasks[slot].store(nullptr);
+  }
+#endif
+
+  // Attribute allocation counts to a competition mode
+  void set_mode(ROBOT_MODE mode) {
+    current_mode = mode;
+  }
+
+  Chunk *bin_at(std::size_t i) {
+    return reinterpret_cast<Chunk *>(reinterpret_cast<char *>(&__malloc_av_[2 * i + 2]) - 2 * sizeof(std::size_t));
+  }
+
+  std::size_t chunk_size(const Chunk *chunk) {
+    return chunk->size & ~SIZE_BITS;
+  }
+
+  // Largest malloc that would succeed right now (to within a page), from the
+  // allocator's free lists and the top chunk plus what sbrk has left. Never
+  // allocates, but holds the malloc lock for one walk of the bins.
+  std::size_t find_largest_block() {
+    const std::size_t overhead = sizeof(std::size_t);    // size field in front of every allocation
+    std::size_t largest = 0;
+
+    __malloc_lock(_impure_ptr);
+
+    for (std::size_t i = 1; i < BIN_COUNT; i++) {
+      Chunk *bin = bin_at(i);
+      for (Chunk *chunk = bin->fd; chunk != bin; chunk = chunk->fd) {
+        largest = std::max(largest, chunk_size(chunk) - overhead);
+      }
+    }
+
+    // malloc splits the top chunk only if a whole chunk is left over, and
+    // grows it through sbrk in page steps
+    const std::size_t top = chunk_size(bin_at(0)->fd) + (&_heap_end - static_cast<char *>(sbrk(0)));
+    if (top > sizeof(Chunk) + PAGE_SIZE + overhead) {
+      largest = std::max(largest, top - sizeof(Chunk) - PAGE_SIZE - overhead);
+    }
+
+    __malloc_unlock(_impure_ptr);
+
+    return largest;
+  }
+
+  Stats get_stats() {
+    const struct mallinfo info = mallinfo();
+
+    Stats stats = {};
+    stats.arena = info.arena;
+    stats.used = info.uordblks;
+    stats.free = info.fordblks;
+    stats.free_chunks = info.ordblks;
+    stats.largest_block = find_largest_block();
+
+#if HEAP_INSTRUMENT
+    stats.peak = peak.load();
+    for (std::size_t mode = 0; mode < MODE_COUNT; mode++) {
+      stats.allocs[mode] = allocs[mode].load();
+      stats.frees[mode] = frees[mode].load();
+    }
+    stats.violations = violations.load();
+#endif
+
+    return stats;
+  }
+
+  void format(const Stats &stats, char *out, std::size_t size) {
+    snprintf(out, size, "used %u / arena %u, free %u in %u chunks, largest %u, peak %u, "
+             "allocs %lu/%lu/%lu/%lu/%lu, violations %lu",
+             (unsigned)stats.used, (unsigned)stats.arena, (unsigned)stats.free, (unsigned)stats.free_chunks,
+             (unsigned)stats.largest_block, (unsigned)stats.peak,
+             (unsigned long)stats.allocs[MODE_INITIALIZE], (unsigned long)stats.allocs[MODE_COMPETITION_INITIALIZE],
+             (unsigned long)stats.allocs[MODE_DISABLED],
+             (unsigned long)stats.allocs[MODE_AUTONOMOUS], (unsigned long)stats.allocs[MODE_OPCONTROL],
+             (unsigned long)stats.violations);
+  }
+
+  // One line at mode transitions, to watch fragmentation over a day of runs
+  void log_report(const char *when) {
+    if constexpr (LOG_LEVEL >= 3) {
+      char buf[192];
+      format(get_stats(), buf, sizeof(buf));
+      INFO_LOG(std::string("heap (") + when + "): " + buf);
+    }
+  }
+
+  // From the serial console
+  void print_report() {
+    char buf[192];
+    format(get_stats(), buf, sizeof(buf));
+    printf("%s\n", buf);
+  }
+}
+
+#if HEAP_INSTRUMENT
+// Linked with --wrap for the reentrant newlib entry points, which malloc(),
+// free(), new and delete all funnel into (see the Makefile). The wrap also
+// catches newlib's own calls between them: realloc and calloc allocate and
+// free through _malloc_r/_free_r, and malloc frees the old top chunk when
+// it grows the heap. Each wrapper holds the (nestable) malloc lock, so a
+// plain depth count under it tells the outermost call, the only one recorded.
+namespace heap {
+  std::uint32_t depth = 0;    // only touched under __malloc_lock
+}
+
+extern "C" {
+  void *__real__malloc_r(struct _reent *r, std::size_t size);
+  void __real__free_r(struct _reent *r, void *ptr);
+  void *__real__realloc_r(struct _reent *r, void *ptr, std::size_t size);
+  void *__real__calloc_r(struct _reent *r, std::size_t count, std::size_t size);
+
+  void *__wrap__malloc_r(struct _reent *r, std::size_t size) {
+    __malloc_lock(r);
+    const bool outer = heap::depth++ == 0;
+    if (outer) heap::check_section();
+
+    void *ptr = __real__malloc_r(r, size);
+    if (outer && ptr != nullptr) heap::record_alloc(malloc_usable_size(ptr));
+
+    heap::depth--;
+    __malloc_unlock(r);
+    return ptr;
+  }
+
+  void __wrap__free_r(struct _reent *r, void *ptr) {
+    __malloc_lock(r);
+    const bool outer = heap::depth++ == 0;
+    if (outer && ptr != nullptr) heap::record_free(malloc_usable_size(ptr));
+
+    __real__free_r(r, ptr);
+
+    heap::depth--;
+    __malloc_unlock(r);
+  }
+
+  void *__wrap__realloc_r(struct _reent *r, void *ptr, std::size_t size) {
+    __malloc_lock(r);
+    const bool outer = heap::depth++ == 0;
+    if (outer) heap::check_section();
+
+    const std::size_t old_size = ptr != nullptr ? malloc_usable_size(ptr) : 0;
+    void *result = __real__realloc_r(r, ptr, size);
+
+    if (outer && (result != nullptr || size == 0)) {
+      if (ptr != nullptr) heap::record_free(old_size);
+      if (result != nullptr) heap::record_alloc(malloc_usable_size(result));
+    }
+
+    heap::depth--;
+    __malloc_unlock(r);
+    return result;
+  }
+
+  void *__wrap__calloc_r(struct _reent *r, std::size_t count, std::size_t size) {
+    __malloc_lock(r);
+    const bool outer = heap::depth++ == 0;
+    if (outer) heap::check_section();
+
+    void *ptr = __real__calloc_r(r, count, size);
+    if (outer && ptr != nullptr) heap::record_alloc(malloc_usable_size(ptr));
+
+    heap::depth--;
+    __malloc_unlock(r);
+    return ptr;
+  }
+}
+#endif
@@ -0,0 +1,207 @@
+#include "indexer.hpp"
+#include "logging.hpp"
+#include "shooter.hpp"
+
+namespace indexer {
+  const std::uint32_t LOOP_DELAY = 10;
+
+  Config cfg;
+  std::atomic<bool> enabled{false};
+  std::atomic<bool> intake_requested{false};
+  std::atomic<bool> eject_requested{false};
+  std::atomic<bool> fire_requested{false};
+  std::atomic<int> current_state{INDEX_DISABLED};
+  std::atomic<int> ball_count{0};
+  pros::Mutex state_mutex;    // one loop pass vs. set_enabled(false), so disabling is synchronous
+  pros::Task *task = nullptr;
+
+  void loop() {
+    okapi::Motor intake_l(INTAKE_LEFT_MOTOR_PORT, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
+    okapi::Motor intake_r(INTAKE_RIGHT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
+    pros::ADIAnalogIn intake_sensor(INDEX_INTAKE_SENSOR_PORT);
+    pros::ADIAnalogIn top_sensor(INDEX_TOP_SENSOR_PORT);
+    intake_l.setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+    intake_r.setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
+
+    INDEX_STATE state = INDEX_DISABLED;
+    bool last_intake_seen = false;
+    std::uint32_t state_start = 0;
+    std::uint32_t shots_at_fire = 0;
+    std::uint32_t now = pros::millis();
+
+    auto enter = [&](INDEX_STATE next) {
+      if (next != state) DEBUG_LOG("indexer: " + std::to_string(state) + " -> " + std::to_string(next) +
+                                   ", " + std::to_string(ball_count.load()) + " balls");
+      state = next;
+      state_start = now;
+    };
+
+    while (true) {
+      const bool intake_seen = intake_sensor.get_value() < cfg.ball_threshold;
+      const bool top_seen = top_sensor.get_value() < cfg.ball_threshold;
+
+      state_mutex.take(TIMEOUT_MAX);
+      int balls = ball_count.load();
+
+      // Count balls entering on the line tracker edge. Stalled intakes draw
+      // as much current as a grab, so current alone isn't a ball.
+      if (state == INDEX_INTAKING || state == INDEX_STAGING || state == INDEX_HOLDING) {
+        if (intake_seen && !last_intake_seen) balls = std::min(balls + 1, cfg.max_balls);
+      }
+      last_intake_seen = intake_seen;
+
+      // A ball at the top is always at least one ball
+      if (top_seen && balls == 0) balls = 1;
+
+      // Transitions. set_enabled(false) already stopped everything, the
+      // mechanisms may belong to auton by now, so don't touch them.
+      if (!enabled) {
+        enter(INDEX_DISABLED);
+      }
+      else if (eject_requested) {
+        if (state != INDEX_EJECTING) enter(INDEX_EJECTING);
+        balls = 0;
+      }
+      else if (fire_requested && state != INDEX_FIRING) {
+        // Even with no balls counted: a misread or unplugged sensor mustn't
+        // stop the driver shooting
+        fire_requested = false;
+        shots_at_fire = shooter::get_shots();
+        enter(INDEX_FIRING);
+      }
+      else {
+        switch (state) {
+          case INDEX_DISABLED:
+          case INDEX_EJECTING:
+            enter(INDEX_IDLE);
+            break;
+
+          case INDEX_IDLE:
+            if (balls > 0 && !top_seen) enter(INDEX_STAGING);
+            else if (intake_requested) enter(INDEX_INTAKING);
+            else if (top_seen) enter(INDEX_HOLDING);
+            break;
+
+          case INDEX_INTAKING:
+            if (balls > 0 && !top_seen) enter(INDEX_STAGING);
+            else if (!intake_requested) enter(INDEX_IDLE);
+            break;
+
+          case INDEX_STAGING:
+            if (top_seen) enter(INDEX_HOLDING);
+            else if (now - state_start > cfg.stage_timeout) {
+              balls = 0;    // ball fell out or was miscounted
+              enter(INDEX_IDLE);
+            }
+            break;
+
+          case INDEX_HOLDING:
+            if (!top_seen) enter(balls > 0 ? INDEX_STAGING : INDEX_IDLE);
+            break;
+
+          case INDEX_FIRING:
+            // Done once the shooter saw the ball go through and the top is clear
+            if ((shooter::get_shots() != shots_at_fire && !top_seen) || now - state_start > cfg.fire_timeout) {
+              balls = std::max(balls - 1, 0);
+              enter(balls > 0 ? INDEX_STAGING : INDEX_IDLE);
+            }
+            break;
+        }
+      }
+
+      // Outputs
+      double intake_velocity = 0;
+      double roller_velocity = 0;
+
+      switch (state) {
+        case INDEX_DISABLED:
+          break;
+
+        case INDEX_IDLE:
+          break;
+
+        case INDEX_INTAKING:
+          intake_velocity = cfg.intake_velocity;
+          break;
+
+        case INDEX_STAGING:
+          intake_velocity = intake_requested ? cfg.intake_velocity : 0;
+          roller_velocity = cfg.stage_velocity;
+          break;
+
+        case INDEX_HOLDING:
+          // Keep pulling more in, but only up to the staged ball
+          intake_velocity = (intake_requested && balls < cfg.max_balls) ? cfg.intake_velocity : 0;
+          break;
+
+        case INDEX_FIRING:
+          intake_velocity = cfg.feed_velocity;
+          roller_velocity = cfg.fire_velocity;
+          break;
+
+        case INDEX_EJECTING:
+          intake_velocity = -cfg.intake_velocity;
+          roller_velocity = -cfg.fire_velocity;
+          break;
+      }
+
+      if (state != INDEX_DISABLED) {
+        intake_l.moveVelocity(intake_velocity);
+        intake_r.moveVelocity(intake_velocity);
+        shooter::set_target(roller_velocity);
+      }
+
+      ball_count = balls;
+      current_state = state;
+      state_mutex.give();
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the indexing task (disabled until set_enabled), call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    cfg = config;
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Indexer");
+  }
+
+  // While disabled the indexer leaves the intakes and rollers alone. Disabling
+  // stops them before returning, so the caller can take them over right away.
+  void set_enabled(bool ienabled) {
+    state_mutex.take(TIMEOUT_MAX);
+    if (!ienabled && enabled) {
+      pros::c::motor_move_velocity(INTAKE_LEFT_MOTOR_PORT, 0);
+      pros::c::motor_move_velocity(INTAKE_RIGHT_MOTOR_PORT, 0);
+      shooter::set_target(0);
+      current_state = INDEX_DISABLED;
+    }
+    enabled = ienabled;
+    state_mutex.give();
+  }
+
+  // Run the intakes and stage whatever comes in
+  void set_intake(bool intake) {
+    intake_requested = intake;
+  }
+
+  // Reverse everything and forget the balls we were holding
+  void set_eject(bool eject) {
+    eject_requested = eject;
+  }
+
+  // Shoot the staged ball, then stage the next one. Runs a shot cycle even
+  // if no ball is counted.
+  void fire() {
+    fire_requested = true;
+  }
+
+  INDEX_STATE get_state() {
+    return static_cast<INDEX_STATE>(current_state.load());
+  }
+
+  int get_balls() {
+    return ball_count.load();
+  }
+}
@@ -0,0 +1,159 @@
+#include "journal.hpp"
+#include "async_log.hpp"
+#include "timing.hpp"
+
+namespace journal {
+  const std::uint32_t LOOP_DELAY = 50;
+  const std::size_t LINE_MAX = 48;
+
+  const char *const EVENT_NAMES[] = {"mode", "button", "auton_step", "drive", "current_cut", "task_fault"};
+
+  // Slot words: time low, time high, type | arg << 8, value. `sequence` is
+  // the event number + 1 once complete, 0 while a writer is filling it.
+  struct Slot {
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint32_t> words[4];
+  };
+
+  Slot ring[RING_SIZE];
+  std::atomic<std::uint32_t> head{0};        // next event number
+  std::atomic<bool> dump_requested{false};
+  std::atomic<std::uint32_t> lost{0};        // overwritten before they were dumped
+  std::atomic<std::uint32_t> dumped{0};      // stored by the journal task only
+  int sink = -1;
+  pros::Task *task = nullptr;
+
+  // Copy event `number` out of the ring, false if it was overwritten or is
+  // still being written
+  bool read(std::uint32_t number, Event &event) {
+    const Slot &slot = ring[number & (RING_SIZE - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != number + 1) return false;
+
+    std::uint32_t words[4];
+    for (std::size_t i = 0; i < 4; i++) words[i] = slot.words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != number + 1) return false;
+
+    event.time = words[0] | static_cast<std::uint64_t>(words[1]) << 32;
+    event.type = words[2] & 0xFF;
+    event.arg = (words[2] >> 8) & 0xFF;
+    event.value = static_cast<std::int32_t>(words[3]);
+    return true;
+  }
+
+  int format(const Event &event, char *out, std::size_t size) {
+    const char *name = event.type < sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) ? EVENT_NAMES[event.type] : "?";
+    return snprintf(out, size, "%llu,%s,%u,%ld\n", static_cast<unsigned long long>(event.time), name, event.arg,
+                    static_cast<long>(event.value));
+  }
+
+  // Append everything recorded since the last dump to the card. Stops at an
+  // event a writer is still filling and picks it up on the next pass.
+  void write_pending() {
+    const std::uint32_t end = head.load(std::memory_order_acquire);
+    std::uint32_t next = dumped.load(std::memory_order_relaxed);
+    if (end - next > RING_SIZE) {
+      lost += end - next - RING_SIZE;
+      next = end - RING_SIZE;
+    }
+
+    char line[LINE_MAX];
+    for (; next != end; next++) {
+      Event event;
+      if (!read(next, event)) {
+        // Overwritten since we loaded head: gone. Otherwise still being written.
+        if (head.load(std::memory_order_acquire) - next > RING_SIZE) {
+          lost++;
+          continue;
+        }
+        dump_requested = true;
+        break;
+      }
+      const int length = format(event, line, sizeof(line));
+      if (length > 0) async_log::push(sink, line, std::min<std::size_t>(length, sizeof(line) - 1));
+    }
+
+    dumped.store(next, std::memory_order_relaxed);
+    async_log::request_flush();
+  }
+
+  void loop() {
+    std::uint32_t now = pros::millis();
+    while (true) {
+      if (dump_requested.exchange(false)) write_pending();
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the dump task, call once from initialize(). Recording works before this.
+  void init() {
+    if (task != nullptr) return;
+
+    sink = async_log::get_sink(PATH);
+    if (sink < 0) return;
+
+    static const char header[] = "# boot\ntime_us,event,arg,value\n";
+    async_log::push(sink, header, sizeof(header) - 1);
+    task = new pros::Task(loop, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Journal");
+  }
+
+  // Lock free and allocation free, safe from any task at any rate. Asks for a
+  // dump once half the ring is waiting, oldest events are overwritten if it
+  // still isn't dumped in time.
+  void record(JOURNAL_EVENT type, std::uint8_t arg, std::int32_t value) {
+    const std::uint64_t time = timing::micros();
+    const std::uint32_t number = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = ring[number & (RING_SIZE - 1)];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.words[0].store(static_cast<std::uint32_t>(time), std::memory_order_relaxed);
+    slot.words[1].store(static_cast<std::uint32_t>(time >> 32), std::memory_order_relaxed);
+    slot.words[2].store(type | arg << 8, std::memory_order_relaxed);
+    slot.words[3].store(static_cast<std::uint32_t>(value), std::memory_order_relaxed);
+    slot.sequence.store(number + 1, std::memory_order_release);
+
+    if (number + 1 - dumped.load(std::memory_order_relaxed) >= RING_SIZE / 2) dump_requested = true;
+  }
+
+  // Record a competition mode change and get the journal onto the card
+  void set_mode(ROBOT_MODE mode) {
+    record(EVENT_MODE, mode);
+    dump();
+  }
+
+  // Ask the journal task to write out new events, returns immediately
+  void dump() {
+    dump_requested = true;
+  }
+
+  // Up to `max` of the newest events, oldest first
+  std::size_t get_recent(Event *out, std::size_t max) {
+    const std::uint32_t end = head.load(std::memory_order_acquire);
+    const std::uint32_t available = std::min<std::uint32_t>(end, RING_SIZE);
+    std::uint32_t number = end - std::min<std::uint32_t>(available, max);
+
+    std::size_t count = 0;
+    for (; number != end; number++) {
+      if (read(number, out[count])) count++;
+    }
+    return count;
+  }
+
+  // From the serial console
+  void print_recent(std::size_t max) {
+    static Event events[RING_SIZE];    // console task only, too big for its stack
+    const std::size_t count = get_recent(events, std::min(max, RING_SIZE));
+
+    char line[LINE_MAX];
+    for (std::size_t i = 0; i < count; i++) {
+      format(events[i], line, sizeof(line));
+      printf("%s", line);
+    }
+    printf("%u lost\n", static_cast<unsigned>(lost.load()));
+  }
+
+  std::uint32_t get_lost() {
+    return lost.load();
+  }
+}
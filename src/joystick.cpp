@@ -0,0 +1,43 @@
+#include "joystick.hpp"
+
+namespace joystick {
+  constexpr double DEADBAND = 0.05;
+
+  // Linear: the original opcontrol scaling (slow = /4, fast fine turn = /1.5)
+  constexpr CurveTable LINEAR_FULL = linear(DEADBAND, 1.0);
+  constexpr CurveTable LINEAR_HALF = linear(DEADBAND, 0.5);
+  constexpr CurveTable LINEAR_QUARTER = linear(DEADBAND, 0.25);
+  constexpr CurveTable LINEAR_FINE = linear(DEADBAND, 1.0 / 1.5);
+
+  // Smooth: exponential drive for fine control near center, cubic turn
+  constexpr CurveTable SMOOTH_FORWARD = exponential(DEADBAND, 2.5, 1.0);
+  constexpr CurveTable SMOOTH_FORWARD_SLOW = exponential(DEADBAND, 1.5, 0.25);
+  constexpr CurveTable SMOOTH_TURN = cubic(DEADBAND, 0.6, 1.0);
+  constexpr CurveTable SMOOTH_TURN_SLOW = cubic(DEADBAND, 0.4, 0.5);
+  constexpr CurveTable SMOOTH_FINE = cubic(DEADBAND, 0.6, 1.0 / 1.5);
+  constexpr CurveTable SMOOTH_FINE_SLOW = cubic(DEADBAND, 0.4, 0.25);
+
+  static_assert(LINEAR_FULL.values[RESOLUTION] == 1.0f, "curves must reach full scale");
+  static_assert(SMOOTH_FORWARD.values[0] == 0.0f && SMOOTH_FORWARD.values[RESOLUTION] > 0.999f, "bad exponential curve");
+
+  // [profile][control mode][drivetrain mode]
+  constexpr DriveCurves CURVES[2][3][2] = {
+    // DRIVER_LINEAR
+    {
+      {{&LINEAR_FULL, &LINEAR_FULL, &LINEAR_FINE}, {&LINEAR_QUARTER, &LINEAR_FULL, &LINEAR_QUARTER}},      // ARCADE
+      {{&LINEAR_FULL, &LINEAR_FULL, &LINEAR_FULL}, {&LINEAR_QUARTER, &LINEAR_QUARTER, &LINEAR_QUARTER}},   // TANK
+      {{&LINEAR_FULL, &LINEAR_FULL, &LINEAR_FULL}, {&LINEAR_QUARTER, &LINEAR_HALF, &LINEAR_HALF}},         // CURVATURE
+    },
+    // DRIVER_SMOOTH
+    {
+      {{&SMOOTH_FORWARD, &SMOOTH_TURN, &SMOOTH_FINE}, {&SMOOTH_FORWARD_SLOW, &SMOOTH_TURN, &SMOOTH_FINE_SLOW}},
+      {{&SMOOTH_FORWARD, &SMOOTH_FORWARD, &SMOOTH_FORWARD}, {&SMOOTH_FORWARD_SLOW, &SMOOTH_FORWARD_SLOW, &SMOOTH_FORWARD_SLOW}},
+      {{&SMOOTH_FORWARD, &SMOOTH_TURN, &SMOOTH_TURN}, {&SMOOTH_FORWARD_SLOW, &SMOOTH_TURN_SLOW, &SMOOTH_TURN_SLOW}},
+    },
+  };
+
+  // Tables for the current mode combination, all built at compile time
+  const DriveCurves &get_curves(DRIVER_PROFILE profile, CONTROL_MODE control, DRIVETRAIN_MODE drivetrain) {
+    return CURVES[profile][control][drivetrain];
+  }
+}
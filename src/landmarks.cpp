@@ -0,0 +1,117 @@
+#include "landmarks.hpp"
+#include "logging.hpp"
+#include "chassis.hpp"
+
+namespace landmarks {
+  // Audit trail ring buffer
+  Correction audit[AUDIT_SIZE];
+  std::size_t audit_count = 0;
+  pros::Mutex audit_mutex;
+
+  void record(const Correction &correction) {
+    audit_mutex.take(TIMEOUT_MAX);
+    audit[audit_count % AUDIT_SIZE] = correction;
+    audit_count++;
+    audit_mutex.give();
+
+    INFO_LOG(std::string("landmarks: ") + correction.source + " " + correction.before.str() +
+             " -> " + correction.after.str());
+  }
+
+  // Heading rounded to the nearest wall normal (odom starts square to the field)
+  okapi::QAngle nearest_normal(okapi::QAngle theta) {
+    return std::round(theta.convert(okapi::degree) / 90.0) * 90.0 * okapi::degree;
+  }
+
+  // Snap the selected components of the odom state to known-good values. The
+  // read-modify-write happens under the odometry writer lock, so components
+  // that aren't snapped keep every step of integrated motion.
+  okapi::OdomState snap(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                        const okapi::OdomState &truth, int components, const char *source) {
+    okapi::OdomState after;
+
+    const okapi::OdomState before = get_published_odometry(cc)->modify_state(
+      [&](const okapi::OdomState &current) {
+        after = current;
+        if (components & POSE_X) after.x = truth.x;
+        if (components & POSE_Y) after.y = truth.y;
+        if (components & POSE_THETA) after.theta = truth.theta;
+        return after;
+      },
+      okapi::StateMode::CARTESIAN
+    );
+
+    record({pros::millis(), source, components, before, after});
+    return after;
+  }
+
+  // Flush against a wall: heading must be a wall normal
+  okapi::OdomState wall_contact(const std::shared_ptr<okapi::OdomChassisController> &cc, const char *source) {
+    okapi::OdomState truth;
+    truth.theta = nearest_normal(cc->getState().theta);
+    return snap(cc, truth, POSE_THETA, source);
+  }
+
+  // Flush against a wall at a known coordinate: also snaps the axis the wall
+  // faces. offset is wall contact to robot centre.
+  okapi::OdomState wall_contact(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                                okapi::QLength wall, okapi::QLength offset, bool backwards, const char *source) {
+    okapi::OdomState truth;
+    truth.theta = nearest_normal(cc->getState().theta);
+
+    // CARTESIAN: 0 deg is +y, 90 deg is +x
+    const double heading = truth.theta.convert(okapi::radian);
+    const okapi::QLength centre = wall + (backwards ? offset : -offset) *
+      (std::abs(std::sin(heading)) > 0.5 ? std::sin(heading) : std::cos(heading));
+
+    if (std::abs(std::sin(heading)) > 0.5) {
+      truth.x = centre;
+      return snap(cc, truth, POSE_X | POSE_THETA, source);
+    }
+
+    truth.y = centre;
+    return snap(cc, truth, POSE_Y | POSE_THETA, source);
+  }
+
+  // Nosed into a goal: we're standoff away from it along our current heading
+  okapi::OdomState goal_alignment(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                                  const okapi::Point &goal, okapi::QLength standoff, const char *source) {
+    const double heading = cc->getState().theta.convert(okapi::radian);
+
+    okapi::OdomState truth;
+    truth.x = goal.x - standoff * std::sin(heading);
+    truth.y = goal.y - standoff * std::cos(heading);
+    return snap(cc, truth, POSE_X | POSE_Y, source);
+  }
+
+  // Centred on a tile, counted from the (centred) starting tile
+  okapi::OdomState tile(const std::shared_ptr<okapi::OdomChassisController> &cc,
+                        int columns, int rows, const char *source) {
+    okapi::OdomState truth;
+    truth.x = columns * TILE_SIZE;
+    truth.y = rows * TILE_SIZE;
+    return snap(cc, truth, POSE_X | POSE_Y, source);
+  }
+
+  // Oldest first
+  std::vector<Correction> get_corrections() {
+    std::vector<Correction> corrections;
+
+    audit_mutex.take(TIMEOUT_MAX);
+    std::size_t first = audit_count > AUDIT_SIZE ? audit_count - AUDIT_SIZE : 0;
+    for (std::size_t i = first; i < audit_count; i++) {
+      corrections.push_back(audit[i % AUDIT_SIZE]);
+    }
+    audit_mutex.give();
+
+    return corrections;
+  }
+
+  // From the serial console
+  void print_corrections() {
+    for (const Correction &correction : get_corrections()) {
+      printf("%lu %s: %s -> %s\n", (unsigned long)correction.time, correction.source,
+             correction.before.str().c_str(), correction.after.str().c_str());
+    }
+  }
+}
@@ -9,6 +9,7 @@ namespace lcd {
 
   const std::string CTRL_MODE_ARCADE = "CTRL: Arcade";
   const std::string CTRL_MODE_TANK = "CTRL: Tank  ";
+  const std::string CTRL_MODE_CURVATURE = "CTRL: Curve ";
 
   void init() {
     pros::lcd::initialize();
@@ -36,6 +37,8 @@ namespace lcd {
         controller.setText(2, 0, CTRL_MODE_ARCADE); break;
       case TANK:
         controller.setText(2, 0, CTRL_MODE_TANK); break;
+      case CURVATURE:
+        controller.setText(2, 0, CTRL_MODE_CURVATURE); break;
     }
   }
 
@@ -1,13 +1,57 @@
 #include "logging.hpp"
+#include "async_log.hpp"
+#include "matchlog.hpp"
+#include "params.hpp"
+#include "timing.hpp"
 
-std::shared_ptr<okapi::Logger> build_logger(bool competition, bool debug) {
+// Runtime level, same numbering as LOG_LEVEL. Warn by default so okapi's own
+// info output stays off the ring; raise it with "loglevel" or params.txt.
+params::Param<int> LOG_RUNTIME_LEVEL("log.level", 2, 0, 4);
+
+bool logger_competition = false;    // what the default logger was last built for
+bool logger_debug = false;
+
+std::shared_ptr<okapi::Logger> make_logger(FILE *file, bool debug) {
   using namespace okapi;    // simplifies things
 
-  std::shared_ptr<Logger> logger = std::make_shared<okapi::Logger> (
-    okapi::TimeUtilFactory::createDefault().getTimer(),       // required timer
-    competition ? "/usd/log.txt" : "/ser/sout",               // log to SD if competition
-    debug ? Logger::LogLevel::debug : Logger::LogLevel::warn  // debug flag
+  return std::make_shared<okapi::Logger> (
+    okapi::TimeUtilFactory::createDefault().getTimer(),              // required timer
+    file,
+    debug ? Logger::LogLevel::debug : static_cast<Logger::LogLevel>(LOG_RUNTIME_LEVEL.get())   // debug flag
   );
+}
+
+std::shared_ptr<okapi::Logger> build_logger(bool competition, bool debug) {
+  logger_competition = competition;
+  logger_debug = debug;
+
+  // Writes are queued and done by the async_log writer task, so logging from
+  // a control loop never waits on the SD card or serial. Competition logs go
+  // to a new preallocated file per match (see matchlog.cpp).
+  return make_logger(competition ? matchlog::open() : async_log::open("/ser/sout"), debug);   // log to SD if competition
+}
+
+// Rebuild the default logger at the current log.level, writing to the same
+// place (the current match log isn't rotated)
+void apply_log_level() {
+  okapi::Logger::setDefaultLogger(make_logger(logger_competition ? matchlog::reopen() : async_log::open("/ser/sout"),
+                                              logger_debug));
+}
+
+// Cost of one DEBUG_LOG call site in this image, to compare LOG_LEVEL builds
+// (see tools/log_level_compare.sh). The runtime level filters debug out, so
+// at LOG_LEVEL=4 this times the level check and lazy message, below that
+// only the loop.
+void bench_logging(std::uint32_t iterations) {
+  volatile std::uint32_t counter = 0;
+
+  const std::uint64_t start = timing::micros();
+  for (std::uint32_t i = 0; i < iterations; i++) {
+    DEBUG_LOG("logbench " + std::to_string(i));
+    counter = i;
+  }
+  const std::uint64_t elapsed = timing::micros() - start;
 
-  return logger;
+  printf("LOG_LEVEL %d: %.1f ns per DEBUG_LOG call site, %lu calls\n", LOG_LEVEL,
+         1000.0 * elapsed / iterations, static_cast<unsigned long>(iterations));
 }
@@ -4,9 +4,40 @@
 #include "chassis.hpp"
 #include "logging.hpp"
 #include "lcd.hpp"
+#include "slip.hpp"
+#include "landmarks.hpp"
+#include "sysid.hpp"
+#include "battery.hpp"
+#include "shooter.hpp"
+#include "indexer.hpp"
+#include "power.hpp"
+#include "drive_filter.hpp"
+#include "joystick.hpp"
+#include "heading_hold.hpp"
+#include "telemetry.hpp"
+#include "matchlog.hpp"
+#include "serial_link.hpp"
+#include "params.hpp"
+#include "monitor.hpp"
+#include "heap.hpp"
+#include "journal.hpp"
 #include "ports.h"
 #include "enums.h"
 
+// Tunables, change over serial ("set auton.speed 90") or in /usd/params.txt
+params::Param<double> AUTON_SPEED("auton.speed", 100, 10, 200);              // rpm, default max velocity
+params::Param<double> AUTON_SPEED_BACKUP("auton.speed_backup", 200, 10, 200);
+params::Param<double> AUTON_SPEED_MOVE("auton.speed_move", 120, 10, 200);
+params::Param<double> AUTON_SPEED_INTAKE("auton.speed_intake", 80, 10, 200);
+params::Param<double> AUTON_ROLLER_RPM("auton.roller_rpm", 600, 0, 600);
+params::Param<double> AUTON_INTAKE_RPM("auton.intake_rpm", 200, 0, 200);
+params::Param<double> AUTON_THROUGH("auton.through_error", 0, 0, 6);        // in, settle-through hand-off, 0 = full stop
+params::Param<double> HEADING_KP("heading.kp", 0.02, 0, 0.2);
+params::Param<double> HEADING_KD("heading.kd", 0.001, 0, 0.05);
+params::Param<double> HEADING_MAX("heading.max_correction", 0.3, 0, 1);
+params::Param<bool> AUTO_INDEX("indexer.enabled", true, false, true);          // false: L1/R1 intakes, L2/R2 rollers by hand
+params::Param<int> DRIVER("driver.profile", DRIVER_LINEAR, DRIVER_LINEAR, DRIVER_SMOOTH);   // 0 linear, 1 smooth (joystick.cpp)
+
 /**
  * Runs initialization code. This occurs as soon as the program is started.
  *
@@ -14,8 +45,47 @@
  * to keep execution time for this mode under a few seconds.
  */
 void initialize() {
+  heap::set_mode(MODE_INITIALIZE);
+  journal::set_mode(MODE_INITIALIZE);
+
   // Init logger in non-competition mode
   okapi::Logger::setDefaultLogger(build_logger(false, false));
+
+  // Calibrate IMU (~2s), slip detection needs it
+  pros::Imu imu(IMU_PORT);
+  imu.reset();
+  while (imu.is_calibrating()) {
+    pros::delay(10);
+  }
+
+  // Load tunables from SD and start the serial console
+  params::init();
+  apply_log_level();    // log.level may come from params.txt
+
+  // Start writing the event journal to SD (recording works from the start)
+  journal::init();
+
+  // Start task CPU / stack monitor ("tasks" on the serial console)
+  monitor::init();
+
+  // Start wheel slip / collision detector
+  slip::init();
+
+  // Start battery voltage filter for output compensation
+  battery::init();
+
+  // Start motor current / thermal budget
+  power::init();
+
+  // Start roller velocity control
+  shooter::init();
+
+  // Start ball indexer, enabled in opcontrol
+  indexer::init();
+
+  // Start binary telemetry to SD, and the (off by default) serial stream
+  telemetry::init();
+  serial_link::init();
 }
 
 /**
@@ -23,7 +93,12 @@ void initialize() {
  * the VEX Competition Switch, following either autonomous or opcontrol. When
  * the robot is enabled, this task will exit.
  */
-void disabled() {}
+void disabled() {
+  heap::set_mode(MODE_DISABLED);
+  journal::set_mode(MODE_DISABLED);
+  heap::log_report("disabled");
+  matchlog::flush();    // get the last mode's log onto the card
+}
 
 /**
  * Runs after initialize(), and before autonomous when connected to the Field
@@ -35,8 +110,12 @@ void disabled() {}
  * starts.
  */
 void competition_initialize() {
+  heap::set_mode(MODE_COMPETITION_INITIALIZE);
+  journal::set_mode(MODE_COMPETITION_INITIALIZE);
+
   // Override logger with competition mode
   okapi::Logger::setDefaultLogger(build_logger(true, false));
+  telemetry::new_file();
 }
 
 /**
@@ -52,35 +131,41 @@ void competition_initialize() {
  */
 
 void autonomous() {
+  heap::set_mode(MODE_AUTONOMOUS);
+  journal::set_mode(MODE_AUTONOMOUS);
+  heap::log_report("autonomous");
+  matchlog::flush();
+  telemetry::log_mode(FAST, ARCADE, static_cast<DRIVER_PROFILE>(DRIVER.get()));    // marks the run's start for match_analyze
+
   // Init chassis controller and set brake mode + velocity
   std::shared_ptr<okapi::OdomChassisController> chassis = build_chassis_controller();
+  telemetry::set_odometry(get_published_odometry(chassis));
   chassis->getModel()->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-  chassis->setMaxVelocity(100);
+  chassis->setMaxVelocity(battery::limit_velocity(AUTON_SPEED, 200));
+  indexer::set_enabled(false);    // auton sequences intakes + rollers itself
 
   // Init motors
   okapi::Motor intake_l(INTAKE_LEFT_MOTOR_PORT, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
   okapi::Motor intake_r(INTAKE_RIGHT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
-  okapi::Motor rollers_front(ROLLERS_FRONT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
-  okapi::Motor rollers_back(ROLLERS_BACK_MOTOR_PORT, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
 
   // 1-point
-  rollers_front.moveVelocity(600);
-  rollers_back.moveVelocity(600);
-  intake_l.moveVelocity(200);
-  intake_r.moveVelocity(200);
+  journal::record(EVENT_AUTON_STEP, 0);
+  shooter::set_target(AUTON_ROLLER_RPM);
+  intake_l.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
+  intake_r.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
   pros::delay(1000);
-  rollers_front.moveVelocity(0);
-  rollers_back.moveVelocity(0);
+  shooter::set_target(0);
   intake_l.moveVelocity(0);
   intake_r.moveVelocity(0);
 
   // Set up position to intake ball
+  journal::record(EVENT_AUTON_STEP, 1);
   chassis->moveDistance(15_cm);
   pros::delay(200);
   chassis->turnAngle(110_deg);
-  chassis->setMaxVelocity(200);
+  chassis->setMaxVelocity(battery::limit_velocity(AUTON_SPEED_BACKUP, 200));
   chassis->moveDistance(-10_cm);
-  chassis->setMaxVelocity(120);
+  chassis->setMaxVelocity(battery::limit_velocity(AUTON_SPEED_MOVE, 200));
   pros::delay(300);
   chassis->moveDistance(15_cm);
   pros::delay(200);
@@ -88,31 +173,33 @@ void autonomous() {
   pros::delay(200);
 
   // Intake ball
-  chassis->setMaxVelocity(80);
+  journal::record(EVENT_AUTON_STEP, 2);
+  chassis->setMaxVelocity(battery::limit_velocity(AUTON_SPEED_INTAKE, 200));
   chassis->moveDistanceAsync(30_cm);
-  intake_l.moveVelocity(200);
-  intake_r.moveVelocity(200);
+  intake_l.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
+  intake_r.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
   chassis->waitUntilSettled();    // keep intake running
   pros::delay(200);
 
   // Move back
-  chassis->setMaxVelocity(120);
-  chassis->moveDistance(-30_in);
+  journal::record(EVENT_AUTON_STEP, 3);
+  chassis->setMaxVelocity(battery::limit_velocity(AUTON_SPEED_MOVE, 200));
+  move_through(chassis, -30_in, AUTON_THROUGH.get() * okapi::inch, 3000);
   intake_l.moveVelocity(0);
   intake_r.moveVelocity(0);       // stop intakes
   pros::delay(200);
   chassis->turnAngle(-15_deg);    // micro-turn to use wall for align
   pros::delay(200);
-  chassis->moveDistance(-8_in);
+  move_until_contact(chassis, -8_in, 1500);    // stop as soon as we hit the wall
+  landmarks::wall_contact(chassis, "goal wall bump");    // square to the wall now
 
   // Shoot!
-  rollers_front.moveVelocity(600);
-  rollers_back.moveVelocity(600);
-  intake_l.moveVelocity(200);
-  intake_r.moveVelocity(200);
+  journal::record(EVENT_AUTON_STEP, 4);
+  shooter::set_target(AUTON_ROLLER_RPM);
+  intake_l.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
+  intake_r.moveVelocity(battery::limit_velocity(AUTON_INTAKE_RPM, 200));
   pros::delay(1000);
-  rollers_front.moveVelocity(0);
-  rollers_back.moveVelocity(0);
+  shooter::set_target(0);
   intake_l.moveVelocity(0);
   intake_r.moveVelocity(0);
 }
@@ -131,36 +218,62 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
+  heap::set_mode(MODE_OPCONTROL);
+  journal::set_mode(MODE_OPCONTROL);
+  heap::log_report("opcontrol");
+  matchlog::flush();
+
   // Init chassis controller and V5 controller
   std::shared_ptr<okapi::OdomChassisController> chassis = build_chassis_controller();
+  telemetry::set_odometry(get_published_odometry(chassis));
+  std::shared_ptr<FeedforwardDriveModel> drive = build_drive_model();
+  DriveFilter drive_filter;
+  HeadingHold heading_hold(HEADING_KP, 0, HEADING_KD, HEADING_MAX);
+  std::uint32_t params_version = params::get_version();
+  pros::Imu imu(IMU_PORT);
   okapi::Controller controller;
 
-  // Init motors
+  // Hand intakes and rollers to the indexer, unless driving them by hand
+  // (indexer.enabled param, or the left button if a line tracker fails)
   okapi::Motor intake_l(INTAKE_LEFT_MOTOR_PORT, true, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
   okapi::Motor intake_r(INTAKE_RIGHT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::green, okapi::AbstractMotor::encoderUnits::rotations);
-  okapi::Motor rollers_front(ROLLERS_FRONT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
-  okapi::Motor rollers_back(ROLLERS_BACK_MOTOR_PORT, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
+  bool manual_index = !AUTO_INDEX.get();
+  indexer::set_enabled(!manual_index);
 
   // Default modes
   DRIVETRAIN_MODE dt_mode = FAST;
   CONTROL_MODE ctrl_mode = ARCADE;
+  DRIVER_PROFILE driver = static_cast<DRIVER_PROFILE>(DRIVER.get());    // per driver, saved in the params file
 
   // Set brake mode
   chassis->getModel()->setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-  intake_l.setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-  intake_r.setBrakeMode(okapi::AbstractMotor::brakeMode::hold);
-  rollers_front.setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
-  rollers_back.setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
 
   // Initialize LCD
   lcd::init();
   lcd::display_mode(controller, dt_mode);
   lcd::display_mode(controller, ctrl_mode);
+  telemetry::log_mode(dt_mode, ctrl_mode, driver);
 
   int count = 0;    // controller LCD update timer
 
   // Main loop
   while (true) {
+    // Pick up live tuning changes
+    if (params::get_version() != params_version) {
+      params_version = params::get_version();
+      heading_hold.set_gains(HEADING_KP, 0, HEADING_KD, HEADING_MAX);
+
+      if (AUTO_INDEX.get() == manual_index) {
+        manual_index = !AUTO_INDEX.get();
+        indexer::set_enabled(!manual_index);
+      }
+
+      if (DRIVER.get() != driver) {
+        driver = static_cast<DRIVER_PROFILE>(DRIVER.get());
+        telemetry::log_mode(dt_mode, ctrl_mode, driver);
+      }
+    }
+
     // ----------
     // Buttons
     // ----------
@@ -176,6 +289,20 @@ void opcontrol() {
             dt_mode = FAST; break;
         }
         lcd::display_mode(controller, dt_mode);
+        telemetry::log_mode(dt_mode, ctrl_mode, driver);
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::Y), dt_mode);
+      }
+    }
+
+    // Indexer / manual intakes and rollers, for when a line tracker misreads
+    if (controller.getDigital(okapi::ControllerDigital::left)) {
+      pros::delay(50);
+      if (controller.getDigital(okapi::ControllerDigital::left)) {
+        manual_index = !manual_index;
+        indexer::set_enabled(!manual_index);
+        controller.rumble(manual_index ? "-" : ".");
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::left), manual_index);
+        while (controller.getDigital(okapi::ControllerDigital::left)) pros::delay(10);
       }
     }
 
@@ -187,9 +314,13 @@ void opcontrol() {
           case ARCADE:
             ctrl_mode = TANK; break;
           case TANK:
+            ctrl_mode = CURVATURE; break;
+          case CURVATURE:
             ctrl_mode = ARCADE; break;
         }
         lcd::display_mode(controller, ctrl_mode);
+        telemetry::log_mode(dt_mode, ctrl_mode, driver);
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::B), ctrl_mode);
       }
     }
 
@@ -197,7 +328,32 @@ void opcontrol() {
     if (controller.getDigital(okapi::ControllerDigital::A)) {
       pros::delay(50);
       if (controller.getDigital(okapi::ControllerDigital::A)) {
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::A));
         autonomous();
+        drive_filter.reset();
+        heading_hold.release();
+        indexer::set_enabled(!manual_index);    // auton turned it off
+      }
+    }
+
+    // Drivetrain characterization, never on a field
+    if (controller.getDigital(okapi::ControllerDigital::X) && !pros::competition::is_connected()) {
+      pros::delay(50);
+      if (controller.getDigital(okapi::ControllerDigital::X)) {
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::X));
+        if (!sysid::run_all()) {
+          while (controller.getDigital(okapi::ControllerDigital::B)) pros::delay(10);    // aborted, B isn't a mode change
+        }
+      }
+    }
+
+    // Binary telemetry over USB for tuning, replaces the PROS terminal while on
+    if (controller.getDigital(okapi::ControllerDigital::down) && !pros::competition::is_connected()) {
+      pros::delay(50);
+      if (controller.getDigital(okapi::ControllerDigital::down)) {
+        serial_link::set_enabled(!serial_link::is_enabled());
+        journal::record(EVENT_BUTTON, static_cast<std::uint8_t>(okapi::ControllerDigital::down), serial_link::is_enabled());
+        while (controller.getDigital(okapi::ControllerDigital::down)) pros::delay(10);
       }
     }
 
@@ -205,61 +361,88 @@ void opcontrol() {
     // Drive
     // ----------
 
-    // Arcade drive
-    if (ctrl_mode == ARCADE) {
-      float y = controller.getAnalog(okapi::ControllerAnalog::leftY);
-      float left_x = controller.getAnalog(okapi::ControllerAnalog::leftX);
-      float right_x = controller.getAnalog(okapi::ControllerAnalog::rightX);
+    {
+      heap::NoAllocSection no_alloc("opcontrol drive");    // counted in HEAP_INSTRUMENT builds
 
-      double forward = (dt_mode == FAST) ? y : y / 4.0;
-      double yaw = (dt_mode == FAST) ? (left_x / 1.5) + right_x : (left_x / 4.0) + right_x;
+      const joystick::DriveCurves &curves = joystick::get_curves(driver, ctrl_mode, dt_mode);
 
-      chassis->getModel()->arcade(forward, yaw, 0.15);
-    }
+      // Arcade drive
+      if (ctrl_mode == ARCADE) {
+        float y = controller.getAnalog(okapi::ControllerAnalog::leftY);
+        float left_x = controller.getAnalog(okapi::ControllerAnalog::leftX);
+        float right_x = controller.getAnalog(okapi::ControllerAnalog::rightX);
 
-    // Tank drive
-    else if (ctrl_mode == TANK) {
-      float left_y = controller.getAnalog(okapi::ControllerAnalog::leftY);
-      float right_y = controller.getAnalog(okapi::ControllerAnalog::rightY);
+        double forward = curves.forward->lookup(y);
+        double yaw = curves.fine_turn->lookup(left_x) + curves.turn->lookup(right_x);
+        yaw = heading_hold.step(forward, yaw, imu.get_rotation(), pros::millis());    // drive straight when not steering
 
-      double left = (dt_mode == FAST) ? left_y : left_y / 4.0;
-      double right = (dt_mode == FAST) ? right_y : right_y / 4.0;
+        DriveCommand command = drive_filter.arcade(forward, yaw, dt_mode, pros::millis());
+        drive->tank(command.left, command.right);
+      }
 
-      chassis->getModel()->tank(left, right);
-    }
+      // Tank drive
+      else if (ctrl_mode == TANK) {
+        float left_y = controller.getAnalog(okapi::ControllerAnalog::leftY);
+        float right_y = controller.getAnalog(okapi::ControllerAnalog::rightY);
 
-    // ----------
-    // Intakes
-    // ----------
+        double left = curves.forward->lookup(left_y);
+        double right = curves.forward->lookup(right_y);
 
-    if (controller.getDigital(okapi::ControllerDigital::L1)) {
-      intake_l.moveVelocity(200);
-      intake_r.moveVelocity(200);
-    }
-    else if (controller.getDigital(okapi::ControllerDigital::R1)) {
-      intake_l.moveVelocity(-200);
-      intake_r.moveVelocity(-200);
-    }
-    else {
-      intake_l.moveVelocity(0);
-      intake_r.moveVelocity(0);
+        DriveCommand command = drive_filter.tank(left, right, dt_mode, pros::millis());
+        drive->tank(command.left, command.right);
+      }
+
+      // Curvature drive
+      else if (ctrl_mode == CURVATURE) {
+        float y = controller.getAnalog(okapi::ControllerAnalog::leftY);
+        float right_x = controller.getAnalog(okapi::ControllerAnalog::rightX);
+
+        double throttle = curves.forward->lookup(y);
+        double curve = curves.turn->lookup(right_x);
+
+        DriveCommand command = drive_filter.curvature(throttle, curve, dt_mode, pros::millis());
+        drive->tank(command.left, command.right);
+      }
     }
 
     // ----------
-    // Rollers
+    // Intakes / rollers
     // ----------
 
-    if (controller.getDigital(okapi::ControllerDigital::L2)) {
-      rollers_front.moveVelocity(600);
-      rollers_back.moveVelocity(600);
-    }
-    else if (controller.getDigital(okapi::ControllerDigital::R2)) {
-      rollers_front.moveVelocity(-600);
-      rollers_back.moveVelocity(-600);
+    if (manual_index) {
+      // L1/R1 intakes in/out, L2/R2 rollers up/down
+      if (controller.getDigital(okapi::ControllerDigital::L1)) {
+        intake_l.moveVelocity(200);
+        intake_r.moveVelocity(200);
+      }
+      else if (controller.getDigital(okapi::ControllerDigital::R1)) {
+        intake_l.moveVelocity(-200);
+        intake_r.moveVelocity(-200);
+      }
+      else {
+        intake_l.moveVelocity(0);
+        intake_r.moveVelocity(0);
+      }
+
+      if (controller.getDigital(okapi::ControllerDigital::L2)) {
+        shooter::set_target(600);
+      }
+      else if (controller.getDigital(okapi::ControllerDigital::R2)) {
+        shooter::set_target(-600);
+      }
+      else {
+        shooter::set_target(0);
+      }
     }
     else {
-      rollers_front.moveVelocity(0);
-      rollers_back.moveVelocity(0);
+      // L1 intakes and stages, L2 fires, R1/R2 eject
+      indexer::set_intake(controller.getDigital(okapi::ControllerDigital::L1));
+      indexer::set_eject(controller.getDigital(okapi::ControllerDigital::R1) ||
+                         controller.getDigital(okapi::ControllerDigital::R2));
+
+      if (controller.getDigital(okapi::ControllerDigital::L2)) {
+        indexer::fire();    // fires one ball per cycle while held
+      }
     }
 
     // ----------
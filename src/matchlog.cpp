@@ -0,0 +1,47 @@
+#include "matchlog.hpp"
+#include "async_log.hpp"
+#include "block_file.hpp"
+
+namespace matchlog {
+  const char *const SINK_NAME = "matchlog";    // async_log sink, the same across files
+
+  BlockFile file(COUNTER_PATH, PATH_FORMAT, FILE_SIZE, KEEP);
+
+  // Called by the async_log writer
+  void write(const char *data, std::size_t length) {
+    file.write(data, length);
+  }
+
+  void flush_sink() {
+    file.flush();
+  }
+
+  const async_log::SinkOps OPS = {write, flush_sink};
+
+  // Start a new match log and return a FILE for okapi::Logger. Call from
+  // competition_initialize(), which runs each time the robot joins a field,
+  // so every match gets its own file. The file is preallocated here, not on
+  // the writer task.
+  FILE *open() {
+    if (file.prepare()) file.begin();
+    return async_log::open(SINK_NAME, &OPS);
+  }
+
+  // Another FILE on the current match log, for a logger rebuilt mid match
+  FILE *reopen() {
+    return async_log::open(SINK_NAME, &OPS);
+  }
+
+  // Call on mode transitions, the writer flushes after its next batch
+  void flush() {
+    async_log::request_flush();
+  }
+
+  const char *get_path() {
+    return file.get_path();
+  }
+
+  std::uint32_t get_match() {
+    return file.get_number();
+  }
+}
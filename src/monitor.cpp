@@ -0,0 +1,128 @@
+#include "monitor.hpp"
+#include "logging.hpp"
+#include "journal.hpp"
+
+#include <cstring>
+
+// FreeRTOS TaskStatus_t as built into the PROS kernel (FreeRTOS 10, 32-bit
+// UBaseType_t). libpros exports these but no PROS header declares them.
+struct TaskStatus {
+  pros::task_t handle;
+  const char *name;
+  unsigned long number;
+  pros::task_state_e_t state;
+  unsigned long current_priority;
+  unsigned long base_priority;
+  std::uint32_t runtime;
+  std::uint32_t *stack_base;
+  std::uint16_t stack_high_water;    // words
+};
+
+extern "C" unsigned long uxTaskGetSystemState(TaskStatus *status, unsigned long size, std::uint32_t *total_runtime);
+
+namespace monitor {
+  Config cfg;
+  TaskReport reports[MAX_TASKS];
+  std::size_t report_count = 0;
+  pros::Mutex report_mutex;
+  pros::Task *task = nullptr;
+
+  void loop() {
+    static TaskStatus status[MAX_TASKS];    // off the task stack, it's big
+
+    // Last runtime per task number, to turn totals into per-period shares
+    unsigned long numbers[MAX_TASKS] = {};
+    std::uint32_t last_runtime[MAX_TASKS] = {};
+    std::size_t known = 0;
+    std::uint32_t last_total = 0;
+    std::uint32_t flagged[MAX_TASKS] = {};    // task numbers already warned about
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      std::uint32_t total = 0;
+      const std::size_t count = uxTaskGetSystemState(status, MAX_TASKS, &total);
+      const std::uint32_t elapsed = total - last_total;
+      last_total = total;
+
+      TaskReport sampled[MAX_TASKS];
+      unsigned long next_numbers[MAX_TASKS];
+      std::uint32_t next_runtime[MAX_TASKS];
+
+      for (std::size_t i = 0; i < count; i++) {
+        const TaskStatus &s = status[i];
+        TaskReport &report = sampled[i];
+
+        snprintf(report.name, sizeof(report.name), "%s", s.name);
+        report.priority = s.current_priority;
+        report.stack_free = s.stack_high_water;
+
+        // Runtime delta against the previous sample of the same task
+        std::uint32_t previous = s.runtime;
+        for (std::size_t j = 0; j < known; j++) {
+          if (numbers[j] == s.number) previous = last_runtime[j];
+        }
+        report.cpu = elapsed > 0 ? 100.0 * (s.runtime - previous) / elapsed : -1;
+        next_numbers[i] = s.number;
+        next_runtime[i] = s.runtime;
+
+        const bool idle = std::strncmp(s.name, "IDLE", 4) == 0;
+        report.overloaded = !idle && report.cpu > cfg.overload_cpu;
+        report.low_stack = report.stack_free < cfg.low_stack;
+        report.oversized = report.stack_free > cfg.oversized_stack;
+
+        // Warn once per task per problem, oversized is only worth a note in the table
+        const std::uint32_t flags = (report.overloaded ? 1 : 0) | (report.low_stack ? 2 : 0);
+        std::uint32_t &seen = flagged[s.number % MAX_TASKS];
+        if (flags & ~seen) {
+          journal::record(EVENT_TASK_FAULT, flags, static_cast<std::int32_t>(s.number));
+          WARN_LOG(std::string("monitor: ") + report.name + (report.overloaded ? " overloaded " : " ") +
+                   (report.low_stack ? "low stack " : "") + std::to_string(static_cast<int>(report.cpu)) +
+                   "% cpu, " + std::to_string(report.stack_free) + " words free");
+        }
+        seen = flags;
+      }
+
+      std::memcpy(numbers, next_numbers, sizeof(unsigned long) * count);
+      std::memcpy(last_runtime, next_runtime, sizeof(std::uint32_t) * count);
+      known = count;
+
+      report_mutex.take(TIMEOUT_MAX);
+      std::memcpy(reports, sampled, sizeof(TaskReport) * count);
+      report_count = count;
+      report_mutex.give();
+
+      pros::Task::delay_until(&now, cfg.period);
+    }
+  }
+
+  // Start sampling, call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    cfg = config;
+    task = new pros::Task(loop, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Monitor");
+  }
+
+  // Copy of the last sample, returns the number of tasks
+  std::size_t get_report(TaskReport *out, std::size_t max) {
+    report_mutex.take(TIMEOUT_MAX);
+    const std::size_t count = std::min(report_count, max);
+    std::memcpy(out, reports, sizeof(TaskReport) * count);
+    report_mutex.give();
+    return count;
+  }
+
+  // Table to the terminal, from the serial console
+  void print_report() {
+    TaskReport copy[MAX_TASKS];
+    const std::size_t count = get_report(copy, MAX_TASKS);
+
+    printf("%-24s %4s %6s %8s\n", "task", "prio", "cpu%", "stack");
+    for (std::size_t i = 0; i < count; i++) {
+      const TaskReport &report = copy[i];
+      printf("%-24s %4lu %6.1f %8lu%s%s%s\n", report.name, (unsigned long)report.priority, report.cpu,
+             (unsigned long)report.stack_free, report.overloaded ? " OVERLOADED" : "",
+             report.low_stack ? " LOW STACK" : "", report.oversized ? " oversized" : "");
+    }
+  }
+}
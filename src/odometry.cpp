@@ -0,0 +1,115 @@
+#include "odometry.hpp"
+#include "timing.hpp"
+
+#include <cmath>
+
+using namespace okapi;    // simplifies things
+
+PublishedOdometry::PublishedOdometry(std::shared_ptr<Odometry> iodometry)
+  : odometry(std::move(iodometry)) {
+  publish(true);
+}
+
+void PublishedOdometry::setScales(const ChassisScales &ichassisScales) {
+  std::lock_guard<CrossplatformMutex> lock(writer_mutex);
+  odometry->setScales(ichassisScales);
+}
+
+void PublishedOdometry::step() {
+  std::lock_guard<CrossplatformMutex> lock(writer_mutex);
+
+  if (freeze_when && freeze_when()) {
+    // Still step so the encoder deltas are consumed, then undo the motion
+    const OdomState before = odometry->getState(StateMode::FRAME_TRANSFORMATION);
+    odometry->step();
+    odometry->setState(before, StateMode::FRAME_TRANSFORMATION);
+    frozen_steps++;
+  }
+  else {
+    odometry->step();
+  }
+
+  steps++;
+  publish(false);
+}
+
+OdomState PublishedOdometry::getState(const StateMode &imode) const {
+  return to_odom_state(published.load(), imode);
+}
+
+void PublishedOdometry::setState(const OdomState &istate, const StateMode &imode) {
+  std::lock_guard<CrossplatformMutex> lock(writer_mutex);
+  odometry->setState(istate, imode);
+  publish(true);    // a teleport isn't velocity
+}
+
+OdomState PublishedOdometry::modify_state(const std::function<OdomState(const OdomState &)> &imodifier,
+                                          const StateMode &imode) {
+  std::lock_guard<CrossplatformMutex> lock(writer_mutex);
+  const OdomState before = odometry->getState(imode);
+  odometry->setState(imodifier(before), imode);
+  publish(true);
+  return before;
+}
+
+std::shared_ptr<ReadOnlyChassisModel> PublishedOdometry::getModel() {
+  return odometry->getModel();
+}
+
+ChassisScales PublishedOdometry::getScales() {
+  return odometry->getScales();
+}
+
+PoseSnapshot PublishedOdometry::get_snapshot() const {
+  return published.load();
+}
+
+std::uint32_t PublishedOdometry::get_version() const {
+  return published.version();
+}
+
+void PublishedOdometry::set_freeze_when(std::function<bool()> ipredicate) {
+  std::lock_guard<CrossplatformMutex> lock(writer_mutex);
+  freeze_when = std::move(ipredicate);
+}
+
+std::uint32_t PublishedOdometry::get_frozen_steps() const {
+  return frozen_steps.load();
+}
+
+// Caller must hold writer_mutex (or be the constructor)
+void PublishedOdometry::publish(bool reset_velocity) {
+  const OdomState state = odometry->getState(StateMode::FRAME_TRANSFORMATION);
+  const PoseSnapshot last = published.load();
+
+  PoseSnapshot next;
+  next.x = state.x.convert(meter);
+  next.y = state.y.convert(meter);
+  next.theta = state.theta.convert(radian);
+  next.timestamp = timing::micros();
+  next.step = steps;
+  next.linear_velocity = 0;
+  next.angular_velocity = 0;
+
+  const double dt = (next.timestamp - last.timestamp) / 1e6;
+  if (!reset_velocity && dt > 0) {
+    const double dx = next.x - last.x;
+    const double dy = next.y - last.y;
+
+    // Project onto heading so reversing reads as negative velocity
+    next.linear_velocity = (dx * std::cos(next.theta) + dy * std::sin(next.theta)) / dt;
+    // Wrapped to [-pi, pi] so crossing the +-pi seam isn't a spike
+    next.angular_velocity = std::remainder(next.theta - last.theta, 2 * M_PI) / dt;
+  }
+
+  published.store(next);
+}
+
+// Convert a published snapshot into okapi's state for the given mode
+OdomState to_odom_state(const PoseSnapshot &snapshot, const StateMode &mode) {
+  if (mode == StateMode::CARTESIAN) {
+    return {snapshot.y * meter, snapshot.x * meter, snapshot.theta * radian};
+  }
+
+  return {snapshot.x * meter, snapshot.y * meter, snapshot.theta * radian};
+}
@@ -0,0 +1,169 @@
+#include "params.hpp"
+#include "logging.hpp"
+#include "monitor.hpp"
+#include "heap.hpp"
+#include "journal.hpp"
+#include "landmarks.hpp"
+
+#include <cstring>
+
+namespace params {
+  // Constant initialized, so it's valid before any Param constructor runs
+  ParamBase *registry = nullptr;
+  std::atomic<std::uint32_t> version{0};
+  pros::Mutex set_mutex;    // serializes set() so log lines match the stored order
+  pros::Task *task = nullptr;
+
+  ParamBase::ParamBase(const char *iname) : name(iname), next(registry) {
+    registry = this;
+  }
+
+  const char *ParamBase::get_name() const {
+    return name;
+  }
+
+  ParamBase *ParamBase::get_next() const {
+    return next;
+  }
+
+  ParamBase *find(const char *name) {
+    for (ParamBase *param = registry; param != nullptr; param = param->get_next()) {
+      if (std::strcmp(param->get_name(), name) == 0) return param;
+    }
+    return nullptr;
+  }
+
+  // Validate and apply one change, logging it either way. Accepted changes are
+  // info (the match log keeps info), rejected ones warn.
+  bool set(const char *name, const char *value, const char *source) {
+    ParamBase *param = find(name);
+    if (param == nullptr) {
+      WARN_LOG(std::string("params: unknown ") + name + " (" + source + ")");
+      return false;
+    }
+
+    set_mutex.take(TIMEOUT_MAX);
+    char before[24], after[24], range[48];
+    param->format(before, sizeof(before));
+    const bool ok = param->parse(value);
+    param->format(after, sizeof(after));
+    param->format_range(range, sizeof(range));
+    if (ok) version++;
+    set_mutex.give();
+
+    if (ok) INFO_LOG(std::string("params: ") + name + " " + before + " -> " + after + " (" + source + ")");
+    else WARN_LOG(std::string("params: rejected ") + name + " = " + value + ", range " + range + " (" + source + ")");
+    return ok;
+  }
+
+  // Bumped on every accepted change, poll it to re-read gains
+  std::uint32_t get_version() {
+    return version.load();
+  }
+
+  // "name = value" per line, # comments. Returns values applied.
+  int load(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) return 0;
+
+    int applied = 0;
+    char line[96];
+    while (fgets(line, sizeof(line), file)) {
+      char name[48], value[32];
+      if (line[0] == '#' || sscanf(line, " %47[^= ] = %31s", name, value) != 2) continue;
+      if (set(name, value, path)) applied++;
+    }
+
+    fclose(file);
+    return applied;
+  }
+
+  bool save(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) return false;
+
+    for (ParamBase *param = registry; param != nullptr; param = param->get_next()) {
+      char value[24];
+      param->format(value, sizeof(value));
+      fprintf(file, "%s = %s\n", param->get_name(), value);
+    }
+
+    fclose(file);
+    return true;
+  }
+
+  // Serial console: set <name> <value> | get <name> | list | save | tasks | heap | events | landmarks | logbench
+  //                 | loglevel <0-4>
+  void handle(char *line) {
+    char command[12], name[48], value[32];
+    const int fields = sscanf(line, "%11s %47s %31s", command, name, value);
+    if (fields < 1) return;
+
+    if (std::strcmp(command, "set") == 0 && fields == 3) {
+      printf("%s\n", set(name, value, "serial") ? "ok" : "rejected");
+    }
+    else if (std::strcmp(command, "get") == 0 && fields == 2) {
+      ParamBase *param = find(name);
+      if (param == nullptr) {
+        printf("unknown %s\n", name);
+        return;
+      }
+      char current[24], range[48];
+      param->format(current, sizeof(current));
+      param->format_range(range, sizeof(range));
+      printf("%s = %s %s\n", name, current, range);
+    }
+    else if (std::strcmp(command, "list") == 0) {
+      for (ParamBase *param = registry; param != nullptr; param = param->get_next()) {
+        char current[24], range[48];
+        param->format(current, sizeof(current));
+        param->format_range(range, sizeof(range));
+        printf("%s = %s %s\n", param->get_name(), current, range);
+      }
+    }
+    else if (std::strcmp(command, "save") == 0) {
+      printf("%s\n", save() ? "saved" : "save failed");
+    }
+    else if (std::strcmp(command, "tasks") == 0) {
+      monitor::print_report();
+    }
+    else if (std::strcmp(command, "heap") == 0) {
+      heap::print_report();
+    }
+    else if (std::strcmp(command, "events") == 0) {
+      journal::print_recent(32);
+      journal::dump();
+    }
+    else if (std::strcmp(command, "landmarks") == 0) {
+      landmarks::print_corrections();
+    }
+    else if (std::strcmp(command, "logbench") == 0) {
+      bench_logging(100000);
+    }
+    else if (std::strcmp(command, "loglevel") == 0 && fields == 2) {
+      // Same as set log.level, then the logger is rebuilt so it takes effect now
+      if (set("log.level", name, "serial")) apply_log_level();
+      else printf("rejected\n");
+    }
+    else {
+      printf("usage: set <name> <value> | get <name> | list | save | tasks | heap | events | landmarks | logbench"
+             " | loglevel <0-4>\n");
+    }
+  }
+
+  void loop() {
+    char line[128];
+    while (true) {
+      if (fgets(line, sizeof(line), stdin) != nullptr) handle(line);
+      else pros::delay(50);
+    }
+  }
+
+  // Apply the params file and start the serial console, call once from initialize()
+  void init() {
+    if (task != nullptr) return;
+
+    load();
+    task = new pros::Task(loop, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "Params");
+  }
+}
@@ -0,0 +1,152 @@
+#include "power.hpp"
+#include "logging.hpp"
+#include "journal.hpp"
+
+namespace power {
+  const std::uint32_t LOOP_DELAY = 100;    // temperatures and limits don't need to move faster
+
+  struct Managed {
+    std::uint8_t port;
+    PRIORITY priority;
+    const char *name;
+    double limit;    // last applied, mA
+    bool cutting;    // limit is below what it was drawing
+  };
+
+  // Ordered by priority, allocation walks this front to back
+  Managed motors[] = {
+    {LEFT_FRONT_MOTOR_PORT, PRIORITY_DRIVE, "drive LF", 0, false},
+    {LEFT_BACK_MOTOR_PORT, PRIORITY_DRIVE, "drive LB", 0, false},
+    {RIGHT_FRONT_MOTOR_PORT, PRIORITY_DRIVE, "drive RF", 0, false},
+    {RIGHT_BACK_MOTOR_PORT, PRIORITY_DRIVE, "drive RB", 0, false},
+    {ROLLERS_FRONT_MOTOR_PORT, PRIORITY_ROLLERS, "rollers F", 0, false},
+    {ROLLERS_BACK_MOTOR_PORT, PRIORITY_ROLLERS, "rollers B", 0, false},
+    {INTAKE_LEFT_MOTOR_PORT, PRIORITY_INTAKES, "intake L", 0, false},
+    {INTAKE_RIGHT_MOTOR_PORT, PRIORITY_INTAKES, "intake R", 0, false},
+  };
+  const std::size_t MOTOR_COUNT = sizeof(motors) / sizeof(motors[0]);
+
+  Config cfg;
+  std::atomic<std::int32_t> limits[MOTOR_COUNT];
+  std::atomic<std::uint32_t> cut_count{0};
+  pros::Task *task = nullptr;
+
+  // Most current a motor at this temperature should get
+  double thermal_cap(double temperature) {
+    if (temperature <= cfg.derate_start) return cfg.motor_max;
+
+    const double t = std::min((temperature - cfg.derate_start) / (cfg.derate_end - cfg.derate_start), 1.0);
+    return cfg.motor_max * (1.0 - t * (1.0 - cfg.derate_min));
+  }
+
+  void log_change(const Managed &motor, double limit, double draw, double cap) {
+    if constexpr (LOG_LEVEL >= 3) {
+      const char *reason = limit >= draw ? "restored" : (limit < cap ? "budget" : "thermal");
+      char buf[96];
+      snprintf(buf, sizeof(buf), "power: %s (port %d) %.0f -> %.0f mA, drawing %.0f, %s",
+               motor.name, motor.port, motor.limit, limit, draw, reason);
+      INFO_LOG(buf);
+    }
+  }
+
+  // Split `remaining` over motors [i, end) of one priority, each asking for
+  // want[j] - limit[j] more. Returns what's left.
+  double share_out(std::size_t i, std::size_t end, const double *want, double *limit, double remaining) {
+    double wanted = 0;
+    for (std::size_t j = i; j < end; j++) wanted += std::max(want[j] - limit[j], 0.0);
+
+    const double share = wanted > 0 ? std::min(remaining / wanted, 1.0) : 0;
+    for (std::size_t j = i; j < end; j++) limit[j] += std::max(want[j] - limit[j], 0.0) * share;
+
+    return remaining - std::min(wanted, remaining);
+  }
+
+  void loop() {
+    double draw[MOTOR_COUNT];
+    double cap[MOTOR_COUNT];
+    double want[MOTOR_COUNT];
+    double limit[MOTOR_COUNT];
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      // What each motor is drawing, could safely use, and wants this cycle.
+      // Demand follows measured draw, a motor pinned at its limit asks for
+      // its whole thermal cap.
+      for (std::size_t i = 0; i < MOTOR_COUNT; i++) {
+        const std::uint8_t port = motors[i].port;
+        double temperature = pros::c::motor_get_temperature(port);
+        if (!std::isfinite(temperature)) temperature = 0;    // unplugged, PROS_ERR_F
+        const std::int32_t current = pros::c::motor_get_current_draw(port);
+        draw[i] = current == PROS_ERR ? 0 : std::abs(current);
+
+        cap[i] = std::max(thermal_cap(temperature), cfg.motor_floor);
+        want[i] = draw[i] >= motors[i].limit * cfg.saturated ? cap[i] :
+          std::clamp(std::max(draw[i] * cfg.headroom, draw[i] + cfg.margin), cfg.motor_floor, cap[i]);
+        limit[i] = cfg.motor_floor;
+      }
+
+      // Floors first so nothing is starved, then serve demand by priority,
+      // then hand whatever is left out by priority up to each thermal cap.
+      // Idle motors get that spare, so one starting from rest isn't held
+      // at the floor until the next cycle notices it.
+      double remaining = cfg.total_budget - cfg.motor_floor * MOTOR_COUNT;
+      for (const double *target : {static_cast<const double *>(want), static_cast<const double *>(cap)}) {
+        std::size_t i = 0;
+        while (i < MOTOR_COUNT) {
+          std::size_t end = i;
+          while (end < MOTOR_COUNT && motors[end].priority == motors[i].priority) end++;
+          remaining = share_out(i, end, target, limit, remaining);
+          i = end;
+        }
+      }
+
+      for (std::size_t i = 0; i < MOTOR_COUNT; i++) {
+        const double applied = std::round(limit[i]);
+
+        // Only a limit below what the motor is actually drawing is a cut
+        const bool cutting = applied < draw[i];
+        if (cutting && (!motors[i].cutting || applied < motors[i].limit)) {
+          cut_count++;
+          journal::record(EVENT_CURRENT_CUT, motors[i].port, static_cast<std::int32_t>(applied));
+          log_change(motors[i], applied, draw[i], cap[i]);
+        }
+        else if (!cutting && motors[i].cutting) {
+          log_change(motors[i], applied, draw[i], cap[i]);
+        }
+        motors[i].cutting = cutting;
+        motors[i].limit = applied;
+
+        pros::c::motor_set_current_limit(motors[i].port, static_cast<std::int32_t>(applied));
+        limits[i] = static_cast<std::int32_t>(applied);
+      }
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the budget task, call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    cfg = config;
+    for (std::size_t i = 0; i < MOTOR_COUNT; i++) {
+      motors[i].limit = cfg.motor_max;
+      limits[i] = static_cast<std::int32_t>(cfg.motor_max);
+    }
+
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Power");
+  }
+
+  // Current limit last applied to a port in mA, or -1 if we don't manage it
+  std::int32_t get_limit(std::uint8_t port) {
+    for (std::size_t i = 0; i < MOTOR_COUNT; i++) {
+      if (motors[i].port == port) return limits[i].load();
+    }
+    return -1;
+  }
+
+  // Number of times a limit was set below a motor's actual draw, budget or thermal
+  std::uint32_t get_cut_count() {
+    return cut_count.load();
+  }
+}
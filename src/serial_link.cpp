@@ -0,0 +1,134 @@
+#include "serial_link.hpp"
+#include "telemetry.hpp"
+#include "timing.hpp"
+#include "framing.h"
+#include "pros/apix.h"
+
+#include <cstring>
+
+namespace serial_link {
+  using namespace telemetry;    // channel ids and payloads
+
+  const std::uint32_t LOOP_DELAY = 5;    // ms, 200Hz is the fastest any channel can go
+  const std::size_t MAX_FRAME = 1 + 4 + sizeof(MotorsPayload) + 2;
+
+  std::atomic<std::uint32_t> periods[CHANNEL_COUNT + 1];    // ms by channel id, 0 = off
+  std::atomic<bool> enabled{false};
+  std::atomic<std::uint32_t> frames{0};
+  std::atomic<std::uint32_t> dropped{0};
+  pros::Task *task = nullptr;
+
+  std::uint32_t period_of(std::uint32_t rate) {
+    return rate == 0 ? 0 : std::max<std::uint32_t>(1000 / rate, LOOP_DELAY);
+  }
+
+  // Frame, CRC, COBS encode and write one packet. Writes don't block, a full
+  // serial buffer drops the frame instead of stalling the task.
+  void send(CHANNEL_ID channel, const void *payload, std::size_t size) {
+    std::uint8_t frame[MAX_FRAME];
+    std::uint8_t encoded[framing::max_encoded(MAX_FRAME) + 1];
+
+    const std::uint32_t time = static_cast<std::uint32_t>(timing::micros());
+    std::size_t length = 0;
+    frame[length++] = channel;
+    std::memcpy(frame + length, &time, sizeof(time));
+    length += sizeof(time);
+    std::memcpy(frame + length, payload, size);
+    length += size;
+
+    const std::uint16_t crc = framing::crc16(frame, length);
+    std::memcpy(frame + length, &crc, sizeof(crc));
+    length += sizeof(crc);
+
+    std::size_t encoded_length = framing::cobs_encode(frame, length, encoded);
+    encoded[encoded_length++] = framing::DELIMITER;
+
+    if (fwrite(encoded, 1, encoded_length, stdout) == encoded_length) frames++;
+    else dropped++;
+  }
+
+  void loop() {
+    std::uint32_t due[CHANNEL_COUNT + 1] = {};
+    PosePayload pose;
+    MotorsPayload motors;
+    InputsPayload inputs;
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      if (enabled) {
+        for (std::size_t channel = 1; channel <= CHANNEL_COUNT; channel++) {
+          const std::uint32_t period = periods[channel].load();
+          if (period == 0 || static_cast<std::int32_t>(now - due[channel]) < 0) continue;
+          due[channel] = now + period;
+
+          switch (channel) {
+            case CHANNEL_POSE:
+              if (fill_pose(pose)) send(CHANNEL_POSE, &pose, sizeof(pose));
+              break;
+            case CHANNEL_MOTORS:
+              fill_motors(motors);
+              send(CHANNEL_MOTORS, &motors, sizeof(motors));
+              break;
+            case CHANNEL_INPUTS:
+              fill_inputs(inputs);
+              send(CHANNEL_INPUTS, &inputs, sizeof(inputs));
+              break;
+          }
+        }
+
+        fflush(stdout);
+      }
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the streaming task (off until set_enabled), call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    periods[CHANNEL_POSE] = period_of(config.pose_rate);
+    periods[CHANNEL_MOTORS] = period_of(config.motors_rate);
+    periods[CHANNEL_INPUTS] = period_of(config.inputs_rate);
+
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "Serial link");
+  }
+
+  // Switch the USB serial link between the PROS terminal (text, PROS's own
+  // COBS stream multiplexing) and our raw framed binary stream
+  void set_enabled(bool ienabled) {
+    if (ienabled == enabled) return;
+
+    if (ienabled) {
+      fflush(stdout);
+      pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+      pros::c::fdctl(fileno(stdout), SERCTL_NOBLKWRITE, nullptr);
+    }
+    enabled = ienabled;
+
+    if (!ienabled) {
+      pros::delay(LOOP_DELAY * 2);    // let an in-flight batch finish
+      fflush(stdout);
+      pros::c::fdctl(fileno(stdout), SERCTL_BLKWRITE, nullptr);
+      pros::c::serctl(SERCTL_ENABLE_COBS, nullptr);
+    }
+  }
+
+  bool is_enabled() {
+    return enabled.load();
+  }
+
+  void set_rate(CHANNEL_ID channel, std::uint32_t rate) {
+    if (channel == CHANNEL_SESSION || channel > CHANNEL_COUNT) return;
+    periods[channel] = period_of(rate);
+  }
+
+  std::uint32_t get_frames() {
+    return frames.load();
+  }
+
+  // Frames the serial buffer had no room for
+  std::uint32_t get_dropped() {
+    return dropped.load();
+  }
+}
@@ -0,0 +1,119 @@
+#include "settle.hpp"
+#include "logging.hpp"
+#include "telemetry.hpp"
+
+namespace settle {
+  std::atomic<double> next_through_error{0};    // cleared when that move finishes
+  std::atomic<std::uint32_t> total_saved{0};
+  Report last_report{0, 0, 0, false, false};
+  pros::Mutex report_mutex;
+
+  VelocitySettledUtil::VelocitySettledUtil(std::function<double()> ivelocity, const Config &iconfig)
+    : okapi::SettledUtil(okapi::TimeUtilFactory::createDefault().getTimer(), iconfig.at_target_error,
+                         iconfig.at_target_derivative, iconfig.at_target_time * okapi::millisecond),
+      velocity(std::move(ivelocity)),
+      config(iconfig) {}
+
+  bool VelocitySettledUtil::isSettled(double ierror) {
+    const std::uint32_t now = pros::millis();
+    const double derivative = ierror - lastError;
+    lastError = ierror;
+
+    if (settled) return true;
+    if (move_start == 0) move_start = now;
+
+    // Close enough to chain into the next move while still rolling
+    if (through_error > 0 && std::abs(ierror) <= through_error) return finish(now, false, true);
+
+    if (std::abs(ierror) > config.at_target_error || std::abs(derivative) > config.at_target_derivative) {
+      band_start = 0;
+      stopped_start = 0;
+      return false;
+    }
+
+    if (band_start == 0) band_start = now;
+
+    if (std::abs(velocity()) <= config.stopped_velocity) {
+      if (stopped_start == 0) stopped_start = now;
+      if (now - stopped_start >= config.stopped_time) return finish(now, true, false);
+    }
+    else {
+      stopped_start = 0;
+    }
+
+    if (now - band_start >= config.at_target_time) return finish(now, false, false);
+
+    return false;
+  }
+
+  // Called by the controllers at the start of every move
+  void VelocitySettledUtil::reset() {
+    okapi::SettledUtil::reset();
+
+    through_error = next_through_error.load();
+    move_start = 0;
+    band_start = 0;
+    stopped_start = 0;
+    settled = false;
+  }
+
+  bool VelocitySettledUtil::finish(std::uint32_t now, bool early, bool through) {
+    settled = true;
+    if (!config.report) return true;
+
+    // settle_through() only applies to one move
+    if (through_error > 0) next_through_error = 0;
+
+    // Plain SettledUtil needs at_target_time in band from when we entered it.
+    // The fallback exit fires at or (with poll jitter) after that, saving
+    // nothing. A settle-through exit may not have entered the band yet, so
+    // it saves at least at_target_time.
+    const std::uint32_t in_band = band_start == 0 ? 0 : now - band_start;
+    const std::int32_t remaining = static_cast<std::int32_t>(config.at_target_time) - static_cast<std::int32_t>(in_band);
+    const std::uint32_t saved = band_start == 0 && !through ? 0 : static_cast<std::uint32_t>(std::max(remaining, 0));
+
+    Report report{now - move_start, in_band, saved, early, through};
+    report_mutex.take(TIMEOUT_MAX);
+    last_report = report;
+    report_mutex.give();
+    total_saved += saved;
+    telemetry::log_settle(report);
+
+    INFO_LOG("settle: " + std::to_string(report.move_time) + "ms, saved " + std::to_string(report.saved) +
+             "ms" + (report.early ? " (stopped)" : "") + (report.through ? " (through)" : ""));
+
+    return true;
+  }
+
+  // TimeUtil whose SettledUtil watches the given velocity (rpm)
+  okapi::TimeUtil build_time_util(std::function<double()> velocity, const Config &config) {
+    okapi::TimeUtil defaults = okapi::TimeUtilFactory::createDefault();
+
+    return okapi::TimeUtil(
+      defaults.getTimerSupplier(),
+      defaults.getRateSupplier(),
+      okapi::Supplier<std::unique_ptr<okapi::SettledUtil>>([=]() {
+        return std::make_unique<VelocitySettledUtil>(velocity, config);
+      })
+    );
+  }
+
+  // Let the next move count as settled once its error is under this, even
+  // while still moving. Wait on it with isSettled() rather than
+  // waitUntilSettled(), which brakes (see move_through() in chassis.cpp).
+  void settle_through(double error) {
+    next_through_error = error;
+  }
+
+  Report get_last_report() {
+    report_mutex.take(TIMEOUT_MAX);
+    Report report = last_report;
+    report_mutex.give();
+    return report;
+  }
+
+  // ms saved over plain SettledUtil since startup
+  std::uint32_t get_total_saved() {
+    return total_saved.load();
+  }
+}
@@ -0,0 +1,58 @@
+#include "shooter.hpp"
+#include "battery.hpp"
+
+namespace shooter {
+  const std::uint32_t LOOP_DELAY = 10;
+
+  // Task state
+  ShooterController *controller = nullptr;
+  std::atomic<double> requested{0};
+  std::atomic<double> velocity{0};
+  std::atomic<std::uint32_t> shots{0};
+  pros::Task *task = nullptr;
+
+  void loop() {
+    okapi::Motor front(ROLLERS_FRONT_MOTOR_PORT, false, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
+    okapi::Motor back(ROLLERS_BACK_MOTOR_PORT, true, okapi::AbstractMotor::gearset::blue, okapi::AbstractMotor::encoderUnits::rotations);
+    front.setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
+    back.setBrakeMode(okapi::AbstractMotor::brakeMode::coast);
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      const double measured = (front.getActualVelocity() + back.getActualVelocity()) / 2.0;
+      const double current = (front.getCurrentDraw() + back.getCurrentDraw()) / 2.0;
+
+      controller->set_target(requested.load());
+      const double voltage = battery::compensate(controller->step(measured, current, now));
+
+      front.moveVoltage(voltage);
+      back.moveVoltage(voltage);
+
+      velocity = measured;
+      shots = controller->get_shots();
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the roller control task, call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    controller = new ShooterController(config);
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Shooter");
+  }
+
+  // Roller target in rpm, 0 to coast
+  void set_target(double rpm) {
+    requested = rpm;
+  }
+
+  double get_velocity() {
+    return velocity.load();
+  }
+
+  std::uint32_t get_shots() {
+    return shots.load();
+  }
+}
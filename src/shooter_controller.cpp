@@ -0,0 +1,109 @@
+#include "shooter_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace shooter {
+  const double MAX_VOLTAGE = 12000;
+
+  ShooterController::ShooterController(const Config &iconfig) : config(iconfig) {}
+
+  double ShooterController::step(double velocity, double current, std::uint32_t now) {
+    if (target == 0) {
+      reset();
+      return 0;
+    }
+
+    const double sign = target > 0 ? 1 : -1;
+    const double dip = sign * (target - velocity);    // how far below target, in our direction
+
+    // Spinning up from rest (or to a higher target) looks exactly like a
+    // ball: big dip, high current. Only watch once we've reached the target.
+    if (!at_speed) {
+      if (dip < config.recovered_band) at_speed = true;
+    }
+
+    // A ball loading into the rollers drags them down and spikes the current
+    else if (dip > config.dip_velocity && std::abs(current) > config.dip_current) {
+      if (!ball_seen) {
+        shots++;
+        boost_until = now + config.boost_time;
+      }
+      ball_seen = true;
+    }
+    else if (dip < config.recovered_band) {
+      ball_seen = false;
+      boost_until = 0;    // back up to speed, stop boosting early
+    }
+
+    if (now < boost_until) {
+      return sign * MAX_VOLTAGE;
+    }
+
+    return std::clamp(control(velocity), -MAX_VOLTAGE, MAX_VOLTAGE);
+  }
+
+  double ShooterController::control(double velocity) {
+    const double error = target - velocity;
+
+    switch (config.mode) {
+      case SHOOTER_TBH: {
+        output = std::clamp(output + config.tbh_gain * error, -1.0, 1.0);
+
+        // Crossed the target: split the difference with the last crossing
+        if ((error > 0) != (last_error > 0)) {
+          output = (output + tbh) / 2.0;
+          tbh = output;
+        }
+
+        last_error = error;
+        return output * MAX_VOLTAGE;
+      }
+
+      case SHOOTER_BANG_BANG: {
+        const double sign = target > 0 ? 1 : -1;
+        if (sign * error > config.bang_band) return sign * MAX_VOLTAGE;
+        return config.kV * target;
+      }
+
+      case SHOOTER_FEEDFORWARD:
+        return config.kV * target + config.kP * error;
+    }
+
+    return 0;
+  }
+
+  void ShooterController::set_target(double itarget) {
+    // Start TBH from the feedforward guess instead of 0, it converges faster
+    if (itarget != target && config.mode == SHOOTER_TBH) {
+      output = std::clamp(config.kV * itarget / MAX_VOLTAGE, -1.0, 1.0);
+      tbh = output;
+      last_error = itarget - target;
+    }
+
+    if (itarget != target) at_speed = false;
+    target = itarget;
+  }
+
+  double ShooterController::get_target() const {
+    return target;
+  }
+
+  // Balls detected since startup
+  std::uint32_t ShooterController::get_shots() const {
+    return shots;
+  }
+
+  bool ShooterController::is_boosting() const {
+    return boost_until != 0;
+  }
+
+  void ShooterController::reset() {
+    output = 0;
+    tbh = 0;
+    last_error = 0;
+    boost_until = 0;
+    ball_seen = false;
+    at_speed = false;
+  }
+}
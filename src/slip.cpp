@@ -0,0 +1,134 @@
+#include "slip.hpp"
+#include "journal.hpp"
+
+namespace slip {
+  const double GRAVITY = 9.80665;    // m/s^2 per g
+  const std::uint32_t LOOP_DELAY = 10;
+
+  Config cfg;
+  std::atomic<int> current_event{DRIVE_OK};
+  std::atomic<bool> freeze_enabled{true};
+  std::atomic<std::uint32_t> event_counts[4];
+  std::atomic<std::uint32_t> contact_count{0};    // stalls + collisions, for auton
+  pros::Task *task = nullptr;
+
+  // Read through the C API so we don't reconfigure ports the chassis owns.
+  // The chassis sets the right side reversed, so readings are already signed.
+  double side_rpm(std::uint8_t front, std::uint8_t back) {
+    return (pros::c::motor_get_actual_velocity(front) + pros::c::motor_get_actual_velocity(back)) / 2.0;
+  }
+
+  double side_voltage(std::uint8_t front, std::uint8_t back) {
+    return (pros::c::motor_get_voltage(front) + pros::c::motor_get_voltage(back)) / 2.0;
+  }
+
+  // Wheel surface speed in m/s
+  double wheel_speed_of(double rpm) {
+    return rpm / 60.0 * okapi::pi * cfg.wheel_diameter;
+  }
+
+  // Raw per-cycle classification, before debouncing
+  DRIVE_EVENT classify(double wheel_accel, double wheel_yaw,
+                       double imu_accel, double imu_yaw, double voltage, double rpm) {
+    if (imu_accel > cfg.collision_accel) return DRIVE_COLLISION;
+
+    if (std::abs(voltage) > cfg.stall_voltage && std::abs(rpm) < cfg.stall_velocity) return DRIVE_STALL;
+
+    // Compare magnitudes so IMU mounting direction doesn't matter
+    if (std::abs(std::abs(wheel_yaw) - std::abs(imu_yaw)) > cfg.yaw_tolerance) return DRIVE_SLIP;
+    if (std::abs(wheel_accel) - imu_accel > cfg.accel_tolerance) return DRIVE_SLIP;
+
+    return DRIVE_OK;
+  }
+
+  void loop() {
+    pros::Imu imu(IMU_PORT);
+
+    double last_speed = 0;
+    DRIVE_EVENT candidate = DRIVE_OK;
+    int candidate_cycles = 0;
+    std::uint32_t last_seen = 0;
+    std::uint32_t now = pros::millis();
+
+    while (true) {
+      const double left_rpm = side_rpm(LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT);
+      const double right_rpm = side_rpm(RIGHT_FRONT_MOTOR_PORT, RIGHT_BACK_MOTOR_PORT);
+      const double left_speed = wheel_speed_of(left_rpm);
+      const double right_speed = wheel_speed_of(right_rpm);
+      const double wheel_speed = (left_speed + right_speed) / 2.0;
+      const double wheel_accel = (wheel_speed - last_speed) / (LOOP_DELAY / 1000.0) / GRAVITY;
+      const double wheel_yaw = (left_speed - right_speed) / cfg.wheel_track * 180.0 / okapi::pi;
+      last_speed = wheel_speed;
+
+      const pros::c::imu_accel_s_t accel = imu.get_accel();
+      const double imu_accel = std::sqrt(accel.x * accel.x + accel.y * accel.y);
+      const double imu_yaw = imu.get_gyro_rate().z;
+
+      const double voltage = (side_voltage(LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT) +
+                              side_voltage(RIGHT_FRONT_MOTOR_PORT, RIGHT_BACK_MOTOR_PORT)) / 2.0;
+      const double rpm = (left_rpm + right_rpm) / 2.0;
+
+      // IMU reads PROS_ERR (huge) while calibrating/unplugged, ignore it then
+      DRIVE_EVENT raw = imu.is_calibrating() || imu_accel > 100 ? DRIVE_OK :
+        classify(wheel_accel, wheel_yaw, imu_accel, imu_yaw, voltage, rpm);
+
+      // Debounce: collisions are instant, stalls/slips must persist
+      if (raw == candidate) candidate_cycles++;
+      else {
+        candidate = raw;
+        candidate_cycles = 1;
+      }
+
+      int needed = candidate == DRIVE_STALL ? cfg.stall_cycles :
+                   candidate == DRIVE_SLIP ? cfg.confirm_cycles : 1;
+
+      if (candidate != DRIVE_OK && candidate_cycles >= needed) {
+        if (current_event.load() != candidate) {
+          event_counts[candidate]++;
+          journal::record(EVENT_DRIVE, candidate);
+          if (candidate == DRIVE_STALL || candidate == DRIVE_COLLISION) contact_count++;
+        }
+        current_event = candidate;
+        last_seen = now;
+      }
+      else if (current_event.load() != DRIVE_OK && now - last_seen > cfg.hold_time) {
+        current_event = DRIVE_OK;
+      }
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start the detector task, call once from initialize()
+  void init(const Config &config) {
+    if (task != nullptr) return;
+
+    cfg = config;
+    freeze_enabled = config.freeze_odometry;
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Slip detector");
+  }
+
+  DRIVE_EVENT get_event() {
+    return static_cast<DRIVE_EVENT>(current_event.load());
+  }
+
+  // Slip + collision mean the wheels moved but the robot didn't (or not like that)
+  bool should_freeze_odometry() {
+    DRIVE_EVENT event = get_event();
+    return freeze_enabled && (event == DRIVE_SLIP || event == DRIVE_COLLISION);
+  }
+
+  void set_freeze_odometry(bool freeze) {
+    freeze_enabled = freeze;
+  }
+
+  // Number of times an event started since init()
+  std::uint32_t get_event_count(DRIVE_EVENT event) {
+    return event_counts[event].load();
+  }
+
+  // Stalls + collisions, compare before/after a move to detect wall contact
+  std::uint32_t get_contact_count() {
+    return contact_count.load();
+  }
+}
@@ -0,0 +1,119 @@
+#include "sysid.hpp"
+#include "battery.hpp"
+
+namespace sysid {
+  const double WHEEL_CIRCUMFERENCE = 3.25 * 0.0254 * okapi::pi;    // m
+  const std::uint32_t SAMPLE_PERIOD = 10;    // ms, motor data updates every 10ms
+  const pros::controller_digital_e_t ABORT_BUTTON = pros::E_CONTROLLER_DIGITAL_B;
+
+  bool aborted = false;
+
+  // Drive both sides with raw voltages through the C API
+  void drive(double left, double right) {
+    pros::c::motor_move_voltage(LEFT_FRONT_MOTOR_PORT, left);
+    pros::c::motor_move_voltage(LEFT_BACK_MOTOR_PORT, left);
+    pros::c::motor_move_voltage(RIGHT_FRONT_MOTOR_PORT, right);
+    pros::c::motor_move_voltage(RIGHT_BACK_MOTOR_PORT, right);
+  }
+
+  bool abort_requested() {
+    return pros::c::controller_get_digital(pros::E_CONTROLLER_MASTER, ABORT_BUTTON) == 1 ||
+           pros::competition::is_disabled();
+  }
+
+  double side_speed(std::uint8_t front, std::uint8_t back) {
+    double rpm = (pros::c::motor_get_actual_velocity(front) + pros::c::motor_get_actual_velocity(back)) / 2.0;
+    return rpm / 60.0 * WHEEL_CIRCUMFERENCE;
+  }
+
+  // Run one test and keep every sample in RAM, the card is only touched after.
+  // Stops the drive and returns what it has if an abort is requested.
+  std::vector<Sample> run_test(bool angular, bool step, bool reverse, const Config &config) {
+    const double sign = reverse ? -1 : 1;
+    const std::uint32_t duration = step ? config.step_time :
+      static_cast<std::uint32_t>(config.max_voltage / config.ramp_rate * 1000);
+
+    std::vector<Sample> samples;
+    samples.reserve(duration / SAMPLE_PERIOD + 1);
+
+    const std::uint32_t start = pros::millis();
+    std::uint32_t now = start;
+
+    while (now - start < duration) {
+      if (abort_requested()) {
+        aborted = true;
+        drive(0, 0);
+        return samples;
+      }
+
+      const std::uint32_t elapsed = now - start;
+      const double voltage = sign * (step ? config.step_voltage : config.ramp_rate * elapsed / 1000.0);
+
+      // Compensated so the fitted constants are for the nominal battery
+      drive(battery::compensate(angular ? -voltage : voltage), battery::compensate(voltage));
+
+      samples.push_back({
+        elapsed, voltage,
+        side_speed(LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT),
+        side_speed(RIGHT_FRONT_MOTOR_PORT, RIGHT_BACK_MOTOR_PORT)
+      });
+
+      pros::Task::delay_until(&now, SAMPLE_PERIOD);
+    }
+
+    drive(0, 0);
+    pros::delay(config.rest_time);
+
+    return samples;
+  }
+
+  // CSV for tools/sysid_fit.cpp
+  bool save(const std::vector<Sample> &samples, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) return false;
+
+    fprintf(file, "time_ms,voltage_mv,left_mps,right_mps\n");
+    for (const Sample &sample : samples) {
+      fprintf(file, "%lu,%.0f,%.4f,%.4f\n", (unsigned long)sample.time, sample.voltage, sample.left, sample.right);
+    }
+
+    fclose(file);
+    return true;
+  }
+
+  // Quasistatic + step, linear then angular. Every test runs in both
+  // directions, so the robot ends up roughly where it started and kS is
+  // fitted on both signs. Returns false if it was aborted; the tests already
+  // finished are still saved.
+  bool run_all(const Config &config) {
+    struct Test {
+      bool angular, step, reverse;
+      const char *path;
+    };
+    const Test tests[] = {
+      {false, false, false, "/usd/sysid_linear_quasistatic_forward.csv"},
+      {false, false, true, "/usd/sysid_linear_quasistatic_reverse.csv"},
+      {false, true, false, "/usd/sysid_linear_step_forward.csv"},
+      {false, true, true, "/usd/sysid_linear_step_reverse.csv"},
+      {true, false, false, "/usd/sysid_angular_quasistatic_forward.csv"},
+      {true, false, true, "/usd/sysid_angular_quasistatic_reverse.csv"},
+      {true, true, false, "/usd/sysid_angular_step_forward.csv"},
+      {true, true, true, "/usd/sysid_angular_step_reverse.csv"},
+    };
+
+    pros::lcd::set_text(5, "SYSID: running, hold B to stop");
+    aborted = false;
+
+    for (const Test &test : tests) {
+      std::vector<Sample> samples = run_test(test.angular, test.step, test.reverse, config);
+      if (aborted) {
+        pros::lcd::set_text(5, "SYSID: aborted");
+        return false;
+      }
+      save(samples, test.path);
+    }
+
+    pros::lcd::set_text(5, "SYSID: done");
+    return true;
+  }
+}
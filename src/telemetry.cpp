@@ -0,0 +1,252 @@
+#include "telemetry.hpp"
+#include "async_log.hpp"
+#include "block_file.hpp"
+#include "timing.hpp"
+#include "ports.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace telemetry {
+  const std::uint32_t LOOP_DELAY = 10;    // every control cycle
+  const char *const SINK_NAME = "telemetry";    // async_log sink, the same across files
+  const std::uint32_t SESSION_RETRIES = 50;     // ms to wait for ring space for a session header
+
+  // Same order as the motors payload columns
+  const std::uint8_t MOTOR_PORTS[MOTOR_COUNT] = {
+    LEFT_FRONT_MOTOR_PORT, LEFT_BACK_MOTOR_PORT, RIGHT_FRONT_MOTOR_PORT, RIGHT_BACK_MOTOR_PORT,
+    ROLLERS_FRONT_MOTOR_PORT, ROLLERS_BACK_MOTOR_PORT, INTAKE_LEFT_MOTOR_PORT, INTAKE_RIGHT_MOTOR_PORT,
+  };
+
+  int sink = -1;
+  std::uint64_t last_time = 0;
+  std::atomic<std::uint32_t> bytes{0};
+  CrossplatformMutex record_mutex;    // keeps timestamps in stream order, no I/O under it
+
+  BlockFile file(COUNTER_PATH, PATH_FORMAT, FILE_SIZE, KEEP);
+  std::atomic<bool> rotating{false};
+
+  std::shared_ptr<PublishedOdometry> odom;
+  pros::Mutex odom_mutex;
+  pros::Task *task = nullptr;
+
+  // Encode and queue one record. Deltas are taken under the lock so records
+  // from different tasks land in the ring in timestamp order.
+  void write(CHANNEL_ID channel, const void *payload, std::size_t size) {
+    std::uint8_t buf[1 + 10 + sizeof(MotorsPayload)];
+
+    std::lock_guard<CrossplatformMutex> lock(record_mutex);
+    const std::uint64_t now = timing::micros();
+
+    std::size_t length = 0;
+    buf[length++] = channel;
+    length += put_varint(buf + length, now - last_time);
+    std::memcpy(buf + length, payload, size);
+    length += size;
+
+    if (async_log::push(sink, reinterpret_cast<const char *>(buf), length)) {
+      last_time = now;
+      bytes += length;
+    }
+  }
+
+  // Called by the async_log writer
+  void write_sink(const char *data, std::size_t length) {
+    file.write(data, length);
+  }
+
+  void flush_sink() {
+    file.flush();
+  }
+
+  const async_log::SinkOps OPS = {write_sink, flush_sink};
+
+  // Self-describing header, so the decoder reads the schema from the file.
+  // The next file starts with it, at a record boundary.
+  void write_session() {
+    std::uint8_t buf[512];
+    std::size_t length = 0;
+
+    auto put_string = [&](const char *text) {
+      const std::size_t size = std::strlen(text);
+      buf[length++] = size;
+      std::memcpy(buf + length, text, size);
+      length += size;
+    };
+
+    buf[length++] = CHANNEL_SESSION;
+    std::memcpy(buf + length, MAGIC, sizeof(MAGIC));
+    length += sizeof(MAGIC);
+    buf[length++] = VERSION;
+    buf[length++] = CHANNEL_COUNT;
+
+    for (const Channel &channel : CHANNELS) {
+      buf[length++] = channel.id;
+      put_string(channel.name);
+      buf[length++] = channel.field_count;
+
+      for (std::size_t i = 0; i < channel.field_count; i++) {
+        put_string(channel.fields[i].name);
+        buf[length++] = channel.fields[i].type;
+        buf[length++] = channel.fields[i].count;
+      }
+    }
+
+    // A file without its header can't be decoded, so wait for ring space
+    // rather than drop it. Records from other tasks wait on the lock meanwhile.
+    std::lock_guard<CrossplatformMutex> lock(record_mutex);
+    file.begin(bytes.load());
+    for (std::uint32_t i = 0; i < SESSION_RETRIES; i++) {
+      if (async_log::push(sink, reinterpret_cast<const char *>(buf), length)) {
+        last_time = 0;    // first record is absolute
+        bytes += length;
+        return;
+      }
+      pros::delay(1);
+    }
+    printf("telemetry: no room for the session header of %s\n", file.get_path());
+  }
+
+  // Preallocating takes seconds, so it runs on its own task and sampling
+  // carries on into the old file until the new one is ready
+  void rotate(void *) {
+    if (file.prepare()) write_session();
+    rotating = false;
+  }
+
+  // Payload builders, also used by the serial link. False if there's no pose yet.
+  bool fill_pose(PosePayload &pose) {
+    odom_mutex.take(TIMEOUT_MAX);
+    std::shared_ptr<PublishedOdometry> current = odom;
+    odom_mutex.give();
+    if (!current) return false;
+
+    const PoseSnapshot snapshot = current->get_snapshot();
+    pose = {
+      static_cast<float>(snapshot.x), static_cast<float>(snapshot.y), static_cast<float>(snapshot.theta),
+      static_cast<float>(snapshot.linear_velocity), static_cast<float>(snapshot.angular_velocity),
+    };
+    return true;
+  }
+
+  // Unplugged motors read PROS_ERR_F (infinity) or PROS_ERR, which don't fit
+  // the payload types, so range check before narrowing
+  std::int16_t to_i16(double value) {
+    if (!std::isfinite(value) || value <= INT16_MIN || value > INT16_MAX) return MISSING_I16;
+    return static_cast<std::int16_t>(value);
+  }
+
+  std::int16_t to_i16(std::int32_t value) {
+    if (value == PROS_ERR || value <= INT16_MIN || value > INT16_MAX) return MISSING_I16;
+    return static_cast<std::int16_t>(value);
+  }
+
+  void fill_motors(MotorsPayload &motors) {
+    for (std::size_t i = 0; i < MOTOR_COUNT; i++) {
+      const std::uint8_t port = MOTOR_PORTS[i];
+      motors.velocity[i] = to_i16(pros::c::motor_get_actual_velocity(port));
+      motors.current[i] = to_i16(pros::c::motor_get_current_draw(port));
+      motors.voltage[i] = to_i16(pros::c::motor_get_voltage(port));
+
+      const double temperature = pros::c::motor_get_temperature(port);
+      motors.temperature[i] = std::isfinite(temperature) && temperature >= 0 && temperature < MISSING_U8 ?
+        static_cast<std::uint8_t>(temperature) : MISSING_U8;
+    }
+  }
+
+  void fill_inputs(InputsPayload &inputs) {
+    inputs.left_x = pros::c::controller_get_analog(pros::E_CONTROLLER_MASTER, pros::E_CONTROLLER_ANALOG_LEFT_X);
+    inputs.left_y = pros::c::controller_get_analog(pros::E_CONTROLLER_MASTER, pros::E_CONTROLLER_ANALOG_LEFT_Y);
+    inputs.right_x = pros::c::controller_get_analog(pros::E_CONTROLLER_MASTER, pros::E_CONTROLLER_ANALOG_RIGHT_X);
+    inputs.right_y = pros::c::controller_get_analog(pros::E_CONTROLLER_MASTER, pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+
+    inputs.buttons = 0;
+    for (int button = pros::E_CONTROLLER_DIGITAL_L1; button <= pros::E_CONTROLLER_DIGITAL_A; button++) {
+      if (pros::c::controller_get_digital(pros::E_CONTROLLER_MASTER, static_cast<pros::controller_digital_e_t>(button)) == 1) {
+        inputs.buttons |= 1 << (button - pros::E_CONTROLLER_DIGITAL_L1);
+      }
+    }
+  }
+
+  void loop() {
+    PosePayload pose;
+    MotorsPayload motors;
+    InputsPayload inputs;
+    BatteryPayload battery;
+
+    std::uint32_t now = pros::millis();
+    while (true) {
+      if (fill_pose(pose)) write(CHANNEL_POSE, &pose, sizeof(pose));
+
+      fill_motors(motors);
+      write(CHANNEL_MOTORS, &motors, sizeof(motors));
+
+      fill_inputs(inputs);
+      write(CHANNEL_INPUTS, &inputs, sizeof(inputs));
+
+      battery.voltage = static_cast<std::uint16_t>(pros::c::battery_get_voltage());
+      battery.current = static_cast<std::int16_t>(pros::c::battery_get_current());
+      write(CHANNEL_BATTERY, &battery, sizeof(battery));
+
+      pros::Task::delay_until(&now, LOOP_DELAY);
+    }
+  }
+
+  // Start sampling through the async log writer, call once from initialize().
+  // Records before the first file is ready are dropped.
+  void init() {
+    if (task != nullptr) return;
+
+    sink = async_log::get_sink(SINK_NAME, &OPS, true);
+    if (sink < 0) return;
+
+    new_file();
+    task = new pros::Task(loop, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "Telemetry");
+  }
+
+  // Start the next numbered file, from competition_initialize() so each match
+  // gets its own. Ignored while one is still being prepared.
+  void new_file() {
+    if (sink < 0 || rotating.exchange(true)) return;
+    new pros::Task(rotate, nullptr, TASK_PRIORITY_DEFAULT - 2, TASK_STACK_DEPTH_DEFAULT, "Telemetry file");
+  }
+
+  const char *get_path() {
+    return file.get_path();
+  }
+
+  // Odometry to sample poses from, each mode builds its own chassis
+  void set_odometry(std::shared_ptr<PublishedOdometry> odometry) {
+    odom_mutex.take(TIMEOUT_MAX);
+    odom = odometry;
+    odom_mutex.give();
+  }
+
+  void log_mode(DRIVETRAIN_MODE drivetrain, CONTROL_MODE control, DRIVER_PROFILE driver) {
+    if (sink < 0) return;
+
+    const ModePayload mode = {
+      static_cast<std::uint8_t>(drivetrain), static_cast<std::uint8_t>(control),
+      static_cast<std::uint8_t>(driver), pros::competition::get_status(),
+    };
+    write(CHANNEL_MODE, &mode, sizeof(mode));
+  }
+
+  // Called by each reporting settled util as its move finishes
+  void log_settle(const settle::Report &report) {
+    if (sink < 0) return;
+
+    const SettlePayload payload = {
+      report.move_time,
+      static_cast<std::uint16_t>(std::min<std::uint32_t>(report.settle_time, UINT16_MAX)),
+      static_cast<std::uint16_t>(std::min<std::uint32_t>(report.saved, UINT16_MAX)),
+      static_cast<std::uint8_t>((report.early ? SETTLE_EARLY : 0) | (report.through ? SETTLE_THROUGH : 0)),
+    };
+    write(CHANNEL_SETTLE, &payload, sizeof(payload));
+  }
+
+  // Bytes queued since startup
+  std::uint32_t get_bytes() {
+    return bytes.load();
+  }
+}
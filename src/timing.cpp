@@ -0,0 +1,11 @@
+#include "timing.hpp"
+
+// PROS 3.3 has no micros(), but libpros exports the SDK's high-res timer
+extern "C" std::uint64_t vexSystemHighResTimeGet(void);
+
+namespace timing {
+  // Microseconds since the brain started
+  std::uint64_t micros() {
+    return vexSystemHighResTimeGet();
+  }
+}
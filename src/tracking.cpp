@@ -0,0 +1,44 @@
+#include "tracking.hpp"
+
+namespace {
+  // Every chassis (opcontrol's, and the manual auton's built on top of it)
+  // reads the same three ADI encoders, so they're opened once and never shut
+  // down. Shutting them down with one model would break the other's odometry.
+  const pros::c::adi_encoder_t *get_encoders() {
+    static const pros::c::adi_encoder_t encoders[3] = {
+      pros::c::adi_encoder_init(TRACKING_LEFT_TOP_PORT, TRACKING_LEFT_BOTTOM_PORT, TRACKING_LEFT_REVERSED),
+      pros::c::adi_encoder_init(TRACKING_RIGHT_TOP_PORT, TRACKING_RIGHT_BOTTOM_PORT, TRACKING_RIGHT_REVERSED),
+      pros::c::adi_encoder_init(TRACKING_MIDDLE_TOP_PORT, TRACKING_MIDDLE_BOTTOM_PORT, TRACKING_MIDDLE_REVERSED),
+    };
+    return encoders;
+  }
+}
+
+TrackingWheelModel::TrackingWheelModel() : encoders(get_encoders()) {}
+
+// One batched read per odometry cycle, no work between the three samples
+std::valarray<std::int32_t> TrackingWheelModel::getSensorVals() const {
+  const std::int32_t left = pros::c::adi_encoder_get(encoders[0]);
+  const std::int32_t right = pros::c::adi_encoder_get(encoders[1]);
+  const std::int32_t middle = pros::c::adi_encoder_get(encoders[2]);
+
+  return {left - offsets[0], right - offsets[1], middle - offsets[2]};
+}
+
+// Zero this model's view only, the encoders are shared with other chassis
+void TrackingWheelModel::reset_sensors() {
+  for (std::size_t i = 0; i < 3; i++) {
+    offsets[i] = pros::c::adi_encoder_get(encoders[i]);
+  }
+}
+
+// Scales for ThreeEncoderOdometry from tracking_config.h
+okapi::ChassisScales build_tracking_scales() {
+  using namespace okapi;    // simplifies things
+
+  return ChassisScales(
+    {TRACKING_WHEEL_DIAMETER * inch, TRACKING_WHEEL_TRACK * inch,
+     TRACKING_MIDDLE_DISTANCE * inch, TRACKING_MIDDLE_DIAMETER * inch},
+    TRACKING_ENCODER_TPR
+  );
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+# log_level_compare.sh - build-size comparison for LOG_LEVEL (include/logging.hpp)
+#
+# Usage: tools/log_level_compare.sh [low] [high]    (from the project root, needs the PROS toolchain)
+#
+# Builds the project at each level (default 2 and 4) and prints the .text size
+# of every object with a *_LOG call, plus the image sizes. For the cycle side,
+# upload each image and run "logbench" on the serial console: it prints the
+# cost of one DEBUG_LOG call site in that image.
+
+set -e
+
+LOW=${1:-2}
+HIGH=${2:-4}
+SIZE=${SIZE:-arm-none-eabi-size}
+OUT=$(mktemp -d)
+FILES=$(grep -l '_LOG(' src/*.cpp | sed 's|^src/||')
+
+for level in "$LOW" "$HIGH"; do
+  make clean > /dev/null
+  make EXTRA_CXXFLAGS="-DLOG_LEVEL=$level" > /dev/null
+  for file in $FILES; do
+    echo "$file $($SIZE -A "bin/$file.o" | awk '$1 == ".text" || $1 ~ /^\.text\./ { total += $2 } END { print total + 0 }')"
+  done > "$OUT/$level"
+  ls -l bin/*.bin | awk '{ print $NF " " $5 }' > "$OUT/$level.bin"
+done
+
+echo ".text bytes, LOG_LEVEL=$LOW vs LOG_LEVEL=$HIGH"
+join "$OUT/$LOW" "$OUT/$HIGH" | awk '{ printf "  %-24s %8d %8d %+8d\n", $1, $2, $3, $3 - $2; low += $2; high += $3 }
+                                       END { printf "  %-24s %8d %8d %+8d\n", "total", low, high, high - low }'
+echo "image bytes"
+join "$OUT/$LOW.bin" "$OUT/$HIGH.bin" | awk '{ printf "  %-24s %8d %8d %+8d\n", $1, $2, $3, $3 - $2 }'
+
+rm -r "$OUT"
@@ -0,0 +1,556 @@
+// match_analyze.cpp - host-side summaries of /usd/telemetry_NNN.bin match logs
+//
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude -o match_analyze tools/match_analyze.cpp
+// Usage: ./match_analyze [-j jobs] log.bin...
+//        ./match_analyze [-j jobs] --baseline old/*.bin --candidate new/*.bin
+//
+// Reports, per log and over all of them: the telemetry loop period histogram
+// and jitter (gaps between motors records, i.e. how late the 10ms sampling
+// task ran), auton steps and PID settle times (settle records), motor
+// temperature and current curves, and battery sag. Steps are numbered from
+// each autonomous run, i.e. each mode record whose competition status is
+// autonomous and enabled; moves outside those (driver control, autons started
+// by hand) only count towards the settle time stats. Logs are decoded on
+// `jobs` threads (default: all cores).
+//
+// With --baseline/--candidate the two sets are summarized separately and
+// compared, regressions are flagged and the exit status is 2 if there are any.
+// Channels and fields are looked up by name from each session header, so
+// logs from before a channel existed just report it as missing.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry_format.h"
+
+using namespace telemetry;
+
+const std::uint32_t HISTOGRAM_BINS = 25;     // 1ms wide, the last one catches everything slower
+const double CURVE_BIN = 15;                 // s per motor curve point
+const std::size_t MAX_MOTORS = 16;
+
+struct FieldSchema {
+  std::string name;
+  FIELD_TYPE type;
+  std::uint8_t count;
+  std::size_t offset;
+};
+
+struct ChannelSchema {
+  std::string name;
+  std::vector<FieldSchema> fields;
+  std::size_t size = 0;
+
+  const FieldSchema *find(const char *field) const {
+    for (const FieldSchema &schema : fields) {
+      if (schema.name == field) return &schema;
+    }
+    return nullptr;
+  }
+};
+
+const std::uint8_t COMPETITION_DISABLED = 1 << 0;      // pros::competition::get_status() bits
+const std::uint8_t COMPETITION_AUTONOMOUS = 1 << 1;
+
+struct Move {
+  int session;
+  int run;                // autonomous run in this log, -1 outside one
+  std::size_t step;       // index within the run
+  double start;           // s since the session's first record
+  double move_time;       // ms
+  double settle_time;     // ms
+  std::uint8_t flags;
+};
+
+struct CurvePoint {
+  double temperature = 0, current = 0;
+  double peak_temperature = 0, peak_current = 0;
+  std::size_t samples = 0;
+};
+
+struct Summary {
+  std::string path;
+  std::string error;
+  int sessions = 0;
+  std::size_t records = 0;
+
+  std::vector<double> periods;              // ms between motors records
+  std::vector<Move> moves;
+  std::size_t motor_count = 0;
+  std::vector<CurvePoint> curves[MAX_MOTORS];
+
+  std::vector<double> voltages;             // mV, one per battery record
+  double rest_voltage = 0;                  // mV, mean while drawing under 1A
+  double peak_current = 0;                  // mA
+  double voltage_at_peak = 0;               // mV
+};
+
+struct Reader {
+  const std::vector<std::uint8_t> &data;
+  std::size_t pos = 0;
+
+  bool has(std::size_t n) const { return pos + n <= data.size(); }
+  std::uint8_t byte() { return data[pos++]; }
+
+  bool string(std::string &out) {
+    if (!has(1)) return false;
+    const std::size_t length = byte();
+    if (!has(length)) return false;
+    out.assign(reinterpret_cast<const char *>(&data[pos]), length);
+    pos += length;
+    return true;
+  }
+};
+
+// One little-endian value of the given type
+double value_at(FIELD_TYPE type, const std::uint8_t *p) {
+  switch (type) {
+    case FIELD_U8: return p[0];
+    case FIELD_I8: return static_cast<std::int8_t>(p[0]);
+    case FIELD_U16: { std::uint16_t v; std::memcpy(&v, p, 2); return v; }
+    case FIELD_I16: { std::int16_t v; std::memcpy(&v, p, 2); return v; }
+    case FIELD_U32: { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+    case FIELD_I32: { std::int32_t v; std::memcpy(&v, p, 4); return v; }
+    case FIELD_F32: { float v; std::memcpy(&v, p, 4); return v; }
+  }
+  return 0;
+}
+
+double field_value(const FieldSchema *field, const std::uint8_t *payload, std::size_t index = 0) {
+  if (field == nullptr || index >= field->count) return 0;
+  return value_at(field->type, payload + field->offset + index * field_size(field->type));
+}
+
+// Parse a session header (after the CHANNEL_SESSION byte)
+bool read_session(Reader &in, std::map<int, ChannelSchema> &channels) {
+  if (!in.has(sizeof(MAGIC) + 2) || std::memcmp(&in.data[in.pos], MAGIC, sizeof(MAGIC)) != 0) return false;
+  in.pos += sizeof(MAGIC) + 1;    // version, the schema is all we need
+
+  channels.clear();
+  const std::uint8_t count = in.byte();
+  for (int c = 0; c < count; c++) {
+    if (!in.has(1)) return false;
+    const int id = in.byte();
+
+    ChannelSchema schema;
+    if (!in.string(schema.name) || !in.has(1)) return false;
+    const std::uint8_t field_count = in.byte();
+
+    for (int f = 0; f < field_count; f++) {
+      FieldSchema field;
+      if (!in.string(field.name) || !in.has(2)) return false;
+      field.type = static_cast<FIELD_TYPE>(in.byte());
+      field.count = in.byte();
+      field.offset = schema.size;
+      schema.size += field_size(field.type) * field.count;
+      schema.fields.push_back(field);
+    }
+
+    channels[id] = schema;
+  }
+
+  return true;
+}
+
+void add_curve_point(Summary &summary, std::size_t motor, double time, double temperature, double current) {
+  std::vector<CurvePoint> &curve = summary.curves[motor];
+  const std::size_t bin = static_cast<std::size_t>(time / CURVE_BIN);
+  if (curve.size() <= bin) curve.resize(bin + 1);
+
+  CurvePoint &point = curve[bin];
+  point.temperature += temperature;
+  point.current += std::abs(current);
+  point.peak_temperature = std::max(point.peak_temperature, temperature);
+  point.peak_current = std::max(point.peak_current, std::abs(current));
+  point.samples++;
+}
+
+Summary analyze(const std::string &path) {
+  Summary summary;
+  summary.path = path;
+
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    summary.error = "can't open";
+    return summary;
+  }
+
+  std::vector<std::uint8_t> data;
+  std::uint8_t chunk[65536];
+  std::size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + n);
+  fclose(file);
+
+  std::map<int, ChannelSchema> channels;
+  Reader in{data};
+  std::uint64_t time = 0, session_start = 0, last_motors = 0;
+  double offset = 0, session_end = 0;    // s, curves run across sessions back to back
+  double rest_sum = 0;
+  std::size_t rest_count = 0;
+  int run = -1, runs = 0;
+  std::size_t step = 0;
+
+  while (in.has(1)) {
+    const std::uint8_t id = in.byte();
+
+    // The brain preallocates each file with zeros, the first zero that
+    // doesn't start a session header is the end of the data
+    if (id == CHANNEL_SESSION && (!in.has(1) || data[in.pos] == 0)) break;
+
+    if (id == CHANNEL_SESSION) {
+      if (!read_session(in, channels)) {
+        summary.error = "bad session header at byte " + std::to_string(in.pos);
+        break;
+      }
+      summary.sessions++;
+      offset = session_end;
+      time = session_start = last_motors = 0;
+      run = -1;
+      continue;
+    }
+
+    auto entry = channels.find(id);
+    if (entry == channels.end()) {
+      summary.error = "unknown channel " + std::to_string(id) + " at byte " + std::to_string(in.pos - 1);
+      break;
+    }
+    const ChannelSchema &channel = entry->second;
+
+    std::uint64_t delta;
+    const std::size_t varint = get_varint(&data[in.pos], data.size() - in.pos, delta);
+    if (varint == 0 || !in.has(varint + channel.size)) break;    // truncated tail, power cut mid-write
+    in.pos += varint;
+    time += delta;
+    if (session_start == 0) session_start = time;
+
+    const std::uint8_t *payload = &data[in.pos];
+    in.pos += channel.size;
+    summary.records++;
+
+    const double elapsed = (time - session_start) / 1e6;
+    session_end = std::max(session_end, offset + elapsed);
+
+    if (channel.name == "motors") {
+      if (last_motors != 0) summary.periods.push_back((time - last_motors) / 1e3);
+      last_motors = time;
+
+      const FieldSchema *temperature = channel.find("temperature");
+      const FieldSchema *current = channel.find("current");
+      if (temperature == nullptr || current == nullptr) continue;
+
+      summary.motor_count = std::min<std::size_t>(temperature->count, MAX_MOTORS);
+      for (std::size_t motor = 0; motor < summary.motor_count; motor++) {
+        const double motor_temperature = field_value(temperature, payload, motor);
+        const double motor_current = field_value(current, payload, motor);
+        if (motor_temperature == MISSING_U8 || motor_current == MISSING_I16) continue;    // unplugged
+        add_curve_point(summary, motor, offset + elapsed, motor_temperature, motor_current);
+      }
+    }
+    else if (channel.name == "battery") {
+      const double voltage = field_value(channel.find("voltage"), payload);
+      const double current = field_value(channel.find("current"), payload);
+      summary.voltages.push_back(voltage);
+
+      if (current < 1000) {
+        rest_sum += voltage;
+        rest_count++;
+      }
+      if (current > summary.peak_current) {
+        summary.peak_current = current;
+        summary.voltage_at_peak = voltage;
+      }
+    }
+    else if (channel.name == "mode") {
+      const std::uint8_t status = field_value(channel.find("competition"), payload);
+      if ((status & COMPETITION_AUTONOMOUS) && !(status & COMPETITION_DISABLED)) {
+        run = runs++;
+        step = 0;
+      }
+      else {
+        run = -1;
+      }
+    }
+    else if (channel.name == "settle") {
+      summary.moves.push_back({
+        summary.sessions - 1, run, run >= 0 ? step++ : 0, elapsed,
+        field_value(channel.find("move_time"), payload),
+        field_value(channel.find("settle_time"), payload),
+        static_cast<std::uint8_t>(field_value(channel.find("flags"), payload)),
+      });
+    }
+  }
+
+  if (rest_count > 0) summary.rest_voltage = rest_sum / rest_count;
+  return summary;
+}
+
+// ----------
+// Statistics
+// ----------
+
+struct Stats {
+  std::size_t count = 0;
+  double mean = 0, stddev = 0, p50 = 0, p99 = 0, min = 0, max = 0;
+};
+
+Stats stats_of(std::vector<double> values) {
+  Stats stats;
+  stats.count = values.size();
+  if (values.empty()) return stats;
+
+  std::sort(values.begin(), values.end());
+  double sum = 0, squares = 0;
+  for (double value : values) sum += value;
+  stats.mean = sum / values.size();
+  for (double value : values) squares += (value - stats.mean) * (value - stats.mean);
+
+  stats.stddev = std::sqrt(squares / values.size());
+  stats.p50 = values[values.size() / 2];
+  stats.p99 = values[std::min(values.size() - 1, values.size() * 99 / 100)];
+  stats.min = values.front();
+  stats.max = values.back();
+  return stats;
+}
+
+// Everything the comparison looks at, pooled over a set of logs
+struct Totals {
+  std::size_t logs = 0;
+  std::vector<double> periods, move_times, settle_times;
+  std::vector<std::vector<double>> steps;    // move times by step index within an autonomous run
+  double peak_temperature = 0, mean_current = 0;
+  double min_voltage = 0, sag = 0;           // worst min voltage, worst rest - min
+};
+
+Totals total(const std::vector<Summary> &summaries) {
+  Totals totals;
+  double current_sum = 0;
+  std::size_t current_count = 0;
+
+  for (const Summary &summary : summaries) {
+    if (!summary.error.empty() && summary.records == 0) continue;
+    totals.logs++;
+    totals.periods.insert(totals.periods.end(), summary.periods.begin(), summary.periods.end());
+
+    for (const Move &move : summary.moves) {
+      totals.move_times.push_back(move.move_time);
+      totals.settle_times.push_back(move.settle_time);
+      if (move.run < 0) continue;
+      if (totals.steps.size() <= move.step) totals.steps.resize(move.step + 1);
+      totals.steps[move.step].push_back(move.move_time);
+    }
+
+    for (std::size_t motor = 0; motor < summary.motor_count; motor++) {
+      for (const CurvePoint &point : summary.curves[motor]) {
+        totals.peak_temperature = std::max(totals.peak_temperature, point.peak_temperature);
+        current_sum += point.current;
+        current_count += point.samples;
+      }
+    }
+
+    if (!summary.voltages.empty()) {
+      const double min = *std::min_element(summary.voltages.begin(), summary.voltages.end());
+      totals.min_voltage = totals.min_voltage == 0 ? min : std::min(totals.min_voltage, min);
+      if (summary.rest_voltage > 0) totals.sag = std::max(totals.sag, summary.rest_voltage - min);
+    }
+  }
+
+  if (current_count > 0) totals.mean_current = current_sum / current_count;
+  return totals;
+}
+
+// ----------
+// Output
+// ----------
+
+void print_histogram(const std::vector<double> &periods) {
+  std::size_t bins[HISTOGRAM_BINS] = {};
+  for (double period : periods) bins[std::min<std::size_t>(period, HISTOGRAM_BINS - 1)]++;
+
+  std::size_t peak = 1;
+  for (std::size_t count : bins) peak = std::max(peak, count);
+
+  for (std::size_t bin = 0; bin < HISTOGRAM_BINS; bin++) {
+    if (bins[bin] == 0) continue;
+    const int width = static_cast<int>(std::ceil(50.0 * bins[bin] / peak));
+    printf("    %2zu%s ms %8zu %.*s\n", bin, bin == HISTOGRAM_BINS - 1 ? "+" : " ", bins[bin], width,
+           "##################################################");
+  }
+}
+
+void print_summary(const Summary &summary) {
+  printf("== %s: %d sessions, %zu records\n", summary.path.c_str(), summary.sessions, summary.records);
+  if (!summary.error.empty()) printf("  warning: %s\n", summary.error.c_str());
+
+  const Stats period = stats_of(summary.periods);
+  if (period.count > 0) {
+    printf("  loop period: mean %.2f ms, jitter %.2f ms, p50 %.2f, p99 %.2f, max %.2f\n",
+           period.mean, period.stddev, period.p50, period.p99, period.max);
+    print_histogram(summary.periods);
+  }
+
+  if (!summary.moves.empty()) {
+    printf("  moves (move / settle ms, auton run.step):\n");
+    for (std::size_t i = 0; i < summary.moves.size(); i++) {
+      const Move &move = summary.moves[i];
+      char step[24] = "-";
+      if (move.run >= 0) snprintf(step, sizeof(step), "%d.%zu", move.run, move.step);
+      printf("    s%d %7.2fs %6s  %6.0f / %4.0f%s%s\n", move.session, move.start, step, move.move_time,
+             move.settle_time, move.flags & SETTLE_EARLY ? " (stopped)" : "",
+             move.flags & SETTLE_THROUGH ? " (through)" : "");
+    }
+  }
+  else {
+    printf("  no settle records\n");
+  }
+
+  if (summary.motor_count > 0) {
+    printf("  motor curves, %.0fs bins (mean temperature C / mean current mA):\n", CURVE_BIN);
+    for (std::size_t motor = 0; motor < summary.motor_count; motor++) {
+      printf("    %zu:", motor);
+      for (const CurvePoint &point : summary.curves[motor]) {
+        if (point.samples == 0) printf("      -     ");
+        else printf(" %4.1f/%-6.0f", point.temperature / point.samples, point.current / point.samples);
+      }
+      printf("\n");
+    }
+  }
+
+  const Stats voltage = stats_of(summary.voltages);
+  if (voltage.count > 0) {
+    printf("  battery: rest %.0f mV, min %.0f mV (sag %.0f mV), %.0f mV at the %.0f mA peak\n",
+           summary.rest_voltage, voltage.min, summary.rest_voltage - voltage.min,
+           summary.voltage_at_peak, summary.peak_current);
+  }
+  else {
+    printf("  no battery records\n");
+  }
+  printf("\n");
+}
+
+void print_totals(const char *label, const Totals &totals) {
+  const Stats period = stats_of(totals.periods);
+  const Stats move = stats_of(totals.move_times);
+  const Stats settle = stats_of(totals.settle_times);
+
+  printf("== %s: %zu logs\n", label, totals.logs);
+  printf("  loop period: mean %.2f ms, jitter %.2f ms, p99 %.2f, max %.2f\n", period.mean, period.stddev, period.p99,
+         period.max);
+  printf("  moves: %zu, mean %.0f ms, settle mean %.0f ms, p99 %.0f ms\n", move.count, move.mean, settle.mean,
+         settle.p99);
+  printf("  peak motor temperature %.0f C, mean motor current %.0f mA\n", totals.peak_temperature, totals.mean_current);
+  printf("  battery: min %.0f mV, worst sag %.0f mV\n\n", totals.min_voltage, totals.sag);
+}
+
+// Lower is better for everything compared. Flags a regression past both the
+// relative and the absolute slack, so noise on tiny numbers doesn't trip it.
+bool compare(const char *name, double baseline, double candidate, double relative, double absolute) {
+  const double delta = candidate - baseline;
+  const bool regressed = delta > absolute && delta > std::abs(baseline) * relative;
+  printf("  %-24s %10.2f %10.2f %+10.2f%s\n", name, baseline, candidate, delta, regressed ? "  REGRESSION" : "");
+  return regressed;
+}
+
+int print_comparison(const Totals &baseline, const Totals &candidate) {
+  const Stats base_period = stats_of(baseline.periods), cand_period = stats_of(candidate.periods);
+  const Stats base_move = stats_of(baseline.move_times), cand_move = stats_of(candidate.move_times);
+  const Stats base_settle = stats_of(baseline.settle_times), cand_settle = stats_of(candidate.settle_times);
+
+  printf("== comparison %26s %10s %10s\n", "baseline", "candidate", "delta");
+  int regressions = 0;
+  regressions += compare("loop period mean (ms)", base_period.mean, cand_period.mean, 0.05, 0.2);
+  regressions += compare("loop jitter (ms)", base_period.stddev, cand_period.stddev, 0.2, 0.2);
+  regressions += compare("loop period p99 (ms)", base_period.p99, cand_period.p99, 0.1, 0.5);
+  regressions += compare("move mean (ms)", base_move.mean, cand_move.mean, 0.05, 20);
+  regressions += compare("settle mean (ms)", base_settle.mean, cand_settle.mean, 0.1, 10);
+  regressions += compare("peak temperature (C)", baseline.peak_temperature, candidate.peak_temperature, 0, 3);
+  regressions += compare("mean motor current (mA)", baseline.mean_current, candidate.mean_current, 0.1, 50);
+  regressions += compare("battery sag (mV)", baseline.sag, candidate.sag, 0.1, 200);
+
+  // Same auton on both sides, so step n is the same move
+  const std::size_t steps = std::min(baseline.steps.size(), candidate.steps.size());
+  for (std::size_t step = 0; step < steps; step++) {
+    const std::string name = "step " + std::to_string(step) + " (ms)";
+    regressions += compare(name.c_str(), stats_of(baseline.steps[step]).mean, stats_of(candidate.steps[step]).mean,
+                           0.05, 20);
+  }
+
+  printf("\n%d regressions\n", regressions);
+  return regressions > 0 ? 2 : 0;
+}
+
+// Decode every log on `jobs` threads, results stay in argument order
+std::vector<Summary> analyze_all(const std::vector<std::string> &paths, unsigned jobs) {
+  std::vector<Summary> summaries(paths.size());
+  std::atomic<std::size_t> next{0};
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < std::min<std::size_t>(jobs, paths.size()); i++) {
+    workers.emplace_back([&]() {
+      for (std::size_t index = next++; index < paths.size(); index = next++) summaries[index] = analyze(paths[index]);
+    });
+  }
+  for (std::thread &worker : workers) worker.join();
+
+  return summaries;
+}
+
+int main(int argc, char **argv) {
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::string> baseline, candidate;
+  std::vector<std::string> *paths = &baseline;
+  bool comparing = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+      jobs = std::max(1, std::atoi(argv[++i]));
+    }
+    else if (std::strcmp(argv[i], "--baseline") == 0) {
+      paths = &baseline;
+      comparing = true;
+    }
+    else if (std::strcmp(argv[i], "--candidate") == 0) {
+      paths = &candidate;
+      comparing = true;
+    }
+    else {
+      paths->push_back(argv[i]);
+    }
+  }
+
+  if (baseline.empty() || (comparing && candidate.empty())) {
+    fprintf(stderr, "usage: %s [-j jobs] log.bin...\n"
+                    "       %s [-j jobs] --baseline old.bin... --candidate new.bin...\n", argv[0], argv[0]);
+    return 1;
+  }
+
+  const std::vector<Summary> base_summaries = analyze_all(baseline, jobs);
+  for (const Summary &summary : base_summaries) {
+    if (summary.records == 0) fprintf(stderr, "%s: %s\n", summary.path.c_str(), summary.error.empty() ? "empty" : summary.error.c_str());
+  }
+
+  if (!comparing) {
+    for (const Summary &summary : base_summaries) {
+      if (summary.records > 0) print_summary(summary);
+    }
+    if (base_summaries.size() > 1) print_totals("all logs", total(base_summaries));
+    return 0;
+  }
+
+  const std::vector<Summary> cand_summaries = analyze_all(candidate, jobs);
+  for (const Summary &summary : cand_summaries) {
+    if (summary.records == 0) fprintf(stderr, "%s: %s\n", summary.path.c_str(), summary.error.empty() ? "empty" : summary.error.c_str());
+  }
+
+  const Totals base_totals = total(base_summaries);
+  const Totals cand_totals = total(cand_summaries);
+  print_totals("baseline", base_totals);
+  print_totals("candidate", cand_totals);
+  return print_comparison(base_totals, cand_totals);
+}
@@ -0,0 +1,86 @@
+// seqlock_stress.cpp - host-side stress test for include/seqlock.hpp
+//
+// Build: g++ -std=c++17 -O2 -pthread -Iinclude -o seqlock_stress tools/seqlock_stress.cpp
+// Usage: ./seqlock_stress [seconds] [readers]
+//
+// One thread plays the odometry task, publishing a pose snapshot as fast as
+// it can (and every so often at the real 10ms rate), while reader threads
+// check that every snapshot they get is internally consistent and that the
+// step count never goes backwards. Exits 1 on any torn or stale read.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "seqlock.hpp"
+
+// Same layout as PoseSnapshot in odometry.hpp, which needs PROS to include
+struct PoseSnapshot {
+  double x;
+  double y;
+  double theta;
+  double linear_velocity;
+  double angular_velocity;
+  std::uint64_t timestamp;
+  std::uint32_t step;
+};
+
+// Every field is a function of the step, so a mix of two writes shows up
+PoseSnapshot simulate(std::uint32_t step) {
+  const double t = step * 0.01;
+  return {std::cos(t) * t, std::sin(t) * t, std::fmod(t, 6.283185307179586), t * 0.5, -t * 0.25,
+          static_cast<std::uint64_t>(step) * 10000, step};
+}
+
+bool consistent(const PoseSnapshot &snapshot) {
+  const PoseSnapshot expected = simulate(snapshot.step);
+  return snapshot.x == expected.x && snapshot.y == expected.y && snapshot.theta == expected.theta &&
+         snapshot.linear_velocity == expected.linear_velocity &&
+         snapshot.angular_velocity == expected.angular_velocity && snapshot.timestamp == expected.timestamp;
+}
+
+int main(int argc, char **argv) {
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 5;
+  const int reader_count = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  SeqLock<PoseSnapshot> published(simulate(0));
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> torn{0}, backwards{0}, reads{0};
+
+  std::thread writer([&]() {
+    for (std::uint32_t step = 1; running; step++) {
+      published.store(simulate(step));
+      if (step % 100000 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  });
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < reader_count; i++) {
+    readers.emplace_back([&]() {
+      std::uint32_t last_step = 0;
+      std::uint64_t count = 0;
+      while (running) {
+        const PoseSnapshot snapshot = published.load();
+        if (!consistent(snapshot)) torn++;
+        if (snapshot.step < last_step) backwards++;
+        last_step = snapshot.step;
+        count++;
+      }
+      reads += count;
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  running = false;
+  writer.join();
+  for (std::thread &reader : readers) reader.join();
+
+  printf("%u writes, %llu reads, %llu torn, %llu backwards\n", published.version(),
+         static_cast<unsigned long long>(reads.load()), static_cast<unsigned long long>(torn.load()),
+         static_cast<unsigned long long>(backwards.load()));
+  return torn == 0 && backwards == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// serial_receive.cpp - host-side receiver for the framed serial telemetry stream
+//
+// Build: g++ -std=c++17 -O2 -Iinclude -o serial_receive tools/serial_receive.cpp
+// Usage: ./serial_receive /dev/ttyACM0             (CSV rows to stdout, pipe into a plotter)
+//        ./serial_receive /dev/ttyACM0 tuning      (tuning_pose.csv, tuning_motors.csv, ...)
+//        ./serial_receive capture.bin tuning       (replay a raw capture)
+//
+// Turn the stream on with the down arrow in driver control (off-field). Frames
+// that fail COBS or CRC are counted and skipped; stray PROS terminal text
+// between frames ends up there too.
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "framing.h"
+#include "telemetry_format.h"
+
+using namespace telemetry;
+
+volatile std::sig_atomic_t running = 1;
+
+void stop(int) {
+  running = 0;
+}
+
+// Raw mode so the tty driver doesn't eat 0x00 or translate line endings
+void make_raw(int fd) {
+  termios tty;
+  if (tcgetattr(fd, &tty) != 0) return;    // not a tty, e.g. a capture file
+  cfmakeraw(&tty);
+  cfsetspeed(&tty, B115200);
+  tcsetattr(fd, TCSANOW, &tty);
+}
+
+const Channel *find_channel(std::uint8_t id) {
+  for (const Channel &channel : CHANNELS) {
+    if (channel.id == id) return &channel;
+  }
+  return nullptr;
+}
+
+// Largest decoded frame any channel can produce: [u8 channel][u32 time][payload][u16 crc]
+constexpr std::size_t max_frame() {
+  std::size_t largest = 0;
+  for (const Channel &channel : CHANNELS) {
+    const std::size_t size = payload_size(channel.fields, channel.field_count);
+    if (size > largest) largest = size;
+  }
+  return 1 + 4 + largest + 2;
+}
+
+void print_header(FILE *out, const Channel &channel, bool with_name) {
+  fprintf(out, with_name ? "channel,time_us" : "time_us");
+  for (std::size_t f = 0; f < channel.field_count; f++) {
+    const Field &field = channel.fields[f];
+    if (field.count == 1) fprintf(out, ",%s", field.name);
+    else for (int i = 0; i < field.count; i++) fprintf(out, ",%s_%d", field.name, i);
+  }
+  fprintf(out, "\n");
+}
+
+void print_row(FILE *out, const Channel &channel, std::uint32_t time, const std::uint8_t *p, bool with_name) {
+  if (with_name) fprintf(out, "%s,", channel.name);
+  fprintf(out, "%u", time);
+
+  for (std::size_t f = 0; f < channel.field_count; f++) {
+    const Field &field = channel.fields[f];
+    for (int i = 0; i < field.count; i++) {
+      switch (field.type) {
+        case FIELD_U8: fprintf(out, ",%u", p[0]); break;
+        case FIELD_I8: fprintf(out, ",%d", static_cast<std::int8_t>(p[0])); break;
+        case FIELD_U16: { std::uint16_t v; std::memcpy(&v, p, 2); fprintf(out, ",%u", v); break; }
+        case FIELD_I16: { std::int16_t v; std::memcpy(&v, p, 2); fprintf(out, ",%d", v); break; }
+        case FIELD_U32: { std::uint32_t v; std::memcpy(&v, p, 4); fprintf(out, ",%u", v); break; }
+        case FIELD_I32: { std::int32_t v; std::memcpy(&v, p, 4); fprintf(out, ",%d", v); break; }
+        case FIELD_F32: { float v; std::memcpy(&v, p, 4); fprintf(out, ",%.6g", v); break; }
+      }
+      p += field_size(field.type);
+    }
+  }
+  fprintf(out, "\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s device|capture [out_prefix]\n", argv[0]);
+    return 1;
+  }
+
+  const int fd = open(argv[1], O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+  make_raw(fd);
+  std::signal(SIGINT, stop);
+
+  // One file per channel when recording, otherwise tagged rows on stdout
+  const bool to_stdout = argc == 2;
+  FILE *outputs[256] = {};
+  bool header_done[256] = {};
+  for (const Channel &channel : CHANNELS) {
+    if (to_stdout) {
+      outputs[channel.id] = stdout;
+    }
+    else {
+      const std::string path = std::string(argv[2]) + "_" + channel.name + ".csv";
+      outputs[channel.id] = fopen(path.c_str(), "w");
+    }
+  }
+
+  std::vector<std::uint8_t> frame;
+  bool oversized = false;
+  std::uint8_t decoded[max_frame()];
+  std::uint8_t buf[4096];
+  std::size_t good = 0, bad = 0;
+
+  while (running) {
+    const ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) break;
+
+    for (ssize_t i = 0; i < n; i++) {
+      if (buf[i] != framing::DELIMITER) {
+        if (frame.size() < framing::max_encoded(sizeof(decoded))) frame.push_back(buf[i]);
+        else oversized = true;    // not one of ours, count it once the delimiter comes
+        continue;
+      }
+
+      const std::size_t length = frame.empty() || oversized
+                                   ? 0
+                                   : framing::cobs_decode(frame.data(), frame.size(), decoded, sizeof(decoded));
+      frame.clear();
+      oversized = false;
+      if (length < 1 + 4 + 2) {
+        bad++;
+        continue;
+      }
+
+      std::uint16_t crc;
+      std::memcpy(&crc, decoded + length - 2, sizeof(crc));
+      const Channel *channel = find_channel(decoded[0]);
+      if (crc != framing::crc16(decoded, length - 2) || channel == nullptr ||
+          length - 7 != payload_size(channel->fields, channel->field_count)) {
+        bad++;
+        continue;
+      }
+
+      std::uint32_t time;
+      std::memcpy(&time, decoded + 1, sizeof(time));
+
+      FILE *out = outputs[channel->id];
+      if (out == nullptr) continue;
+      if (!header_done[channel->id]) {
+        print_header(out, *channel, to_stdout);
+        header_done[channel->id] = true;
+      }
+      print_row(out, *channel, time, decoded + 5, to_stdout);
+      if (to_stdout) fflush(stdout);
+      good++;
+    }
+  }
+
+  for (const Channel &channel : CHANNELS) {
+    if (!to_stdout && outputs[channel.id] != nullptr) fclose(outputs[channel.id]);
+  }
+  close(fd);
+
+  fprintf(stderr, "%zu frames, %zu bad\n", good, bad);
+  return 0;
+}
@@ -0,0 +1,79 @@
+// shooter_check.cpp - host-side checks for the roller controller's ball detection
+//
+// Build: g++ -std=c++17 -O2 -Iinclude -o shooter_check tools/shooter_check.cpp src/shooter_controller.cpp
+// Usage: ./shooter_check
+//
+// Runs ShooterController against a first-order roller model (blue cartridge,
+// current proportional to the back-EMF gap) and checks that a plain spin-up
+// from rest, in each control mode and to a higher target, counts no shots,
+// and that one ball loaded at speed counts exactly one. Exits 1 on failure.
+
+#include <cmath>
+#include <cstdio>
+
+#include "shooter_controller.hpp"
+
+using namespace shooter;
+
+// Roller pair: free speed 600 rpm at 12V, ~150ms time constant, ~2.5A stall per motor
+struct Roller {
+  double velocity = 0;    // rpm
+
+  // Advance one 10ms step at `voltage` mV with `load` mA of extra torque
+  // (a ball in the rollers), returns current draw in mA
+  double step(double voltage, double load) {
+    const double free_speed = 600.0 * voltage / 12000.0;
+    const double current = 2500.0 * (free_speed - velocity) / 600.0 + load;
+    velocity += (free_speed - velocity - load * 600.0 / 2500.0) * 10.0 / 150.0;
+    return current;
+  }
+};
+
+// Run `ms` of control at `target`, loading a ball from `ball_at` for 60ms
+std::uint32_t run(ShooterController &controller, Roller &roller, double target, std::uint32_t &now,
+                  std::uint32_t ms, std::uint32_t ball_at = 0) {
+  controller.set_target(target);
+  double voltage = 0;
+  for (std::uint32_t end = now + ms; now < end; now += 10) {
+    const bool loading = ball_at != 0 && now >= ball_at && now < ball_at + 60;
+    const double current = roller.step(voltage, loading ? 2000 : 0);
+    voltage = controller.step(roller.velocity, current, now);
+  }
+  return controller.get_shots();
+}
+
+int failures = 0;
+
+void check(const char *name, std::uint32_t shots, std::uint32_t expected) {
+  const bool ok = shots == expected;
+  if (!ok) failures++;
+  printf("%-40s shots %u, expected %u %s\n", name, shots, expected, ok ? "ok" : "FAIL");
+}
+
+int main() {
+  const SHOOTER_MODE modes[] = {SHOOTER_TBH, SHOOTER_BANG_BANG, SHOOTER_FEEDFORWARD};
+  const char *names[] = {"tbh", "bang-bang", "feedforward"};
+
+  for (int i = 0; i < 3; i++) {
+    Config config;
+    config.mode = modes[i];
+    char label[64];
+
+    ShooterController controller(config);
+    Roller roller;
+    std::uint32_t now = 1000;
+
+    snprintf(label, sizeof(label), "%s: 0 -> 600 rpm", names[i]);
+    check(label, run(controller, roller, 600, now, 3000), 0);
+
+    snprintf(label, sizeof(label), "%s: ball at speed", names[i]);
+    check(label, run(controller, roller, 600, now, 2000, now + 500), 1);
+
+    snprintf(label, sizeof(label), "%s: stop, then 0 -> 400 -> 600 rpm", names[i]);
+    run(controller, roller, 0, now, 2000);
+    run(controller, roller, 400, now, 2000);
+    check(label, run(controller, roller, 600, now, 2000), 1);
+  }
+
+  return failures == 0 ? 0 : 1;
+}
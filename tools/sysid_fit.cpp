@@ -0,0 +1,152 @@
+// sysid_fit.cpp - host-side kS/kV/kA fitter for the sysid CSVs
+//
+// Build: g++ -std=c++17 -O2 -o sysid_fit tools/sysid_fit.cpp
+// Usage: ./sysid_fit sysid_*.csv > include/drive_constants.h
+//
+// Files with "angular" in the name feed the angular fit, the rest the linear
+// one. Each fit is ordinary least squares on V = kS*sgn(v) + kV*v + kA*a.
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Point {
+  double voltage;
+  double velocity;
+  double acceleration;
+};
+
+struct Fit {
+  double kS = 0, kV = 0, kA = 0;
+  double r2 = 0;
+  std::size_t samples = 0;
+  bool ok = false;
+};
+
+const double MIN_VELOCITY = 0.02;    // m/s, below this sgn(v) is noise
+const int ACCEL_WINDOW = 3;          // samples either side for the derivative
+
+// Read one sysid CSV, returning (voltage, velocity, acceleration) points
+bool load(const char *path, bool angular, std::vector<Point> &points) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) return false;
+
+  std::vector<double> times, voltages, velocities;
+  char line[256];
+  fgets(line, sizeof(line), file);    // header
+
+  while (fgets(line, sizeof(line), file)) {
+    double time, voltage, left, right;
+    if (sscanf(line, "%lf,%lf,%lf,%lf", &time, &voltage, &left, &right) != 4) continue;
+
+    times.push_back(time / 1000.0);
+    voltages.push_back(voltage);
+    velocities.push_back(angular ? (right - left) / 2.0 : (left + right) / 2.0);
+  }
+  fclose(file);
+
+  for (std::size_t i = ACCEL_WINDOW; i + ACCEL_WINDOW < times.size(); i++) {
+    if (std::abs(velocities[i]) < MIN_VELOCITY) continue;
+
+    const double dt = times[i + ACCEL_WINDOW] - times[i - ACCEL_WINDOW];
+    if (dt <= 0) continue;
+
+    const double accel = (velocities[i + ACCEL_WINDOW] - velocities[i - ACCEL_WINDOW]) / dt;
+    points.push_back({voltages[i], velocities[i], accel});
+  }
+
+  return true;
+}
+
+// Solve the 3x3 normal equations with Gaussian elimination
+Fit fit(const std::vector<Point> &points) {
+  Fit result;
+  result.samples = points.size();
+  if (points.size() < 10) return result;
+
+  double a[3][4] = {};
+  for (const Point &p : points) {
+    const double x[3] = {p.velocity > 0 ? 1.0 : -1.0, p.velocity, p.acceleration};
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) a[r][c] += x[r] * x[c];
+      a[r][3] += x[r] * p.voltage;
+    }
+  }
+
+  for (int col = 0; col < 3; col++) {
+    int pivot = col;
+    for (int r = col + 1; r < 3; r++) {
+      if (std::abs(a[r][col]) > std::abs(a[pivot][col])) pivot = r;
+    }
+    if (std::abs(a[pivot][col]) < 1e-12) return result;
+    for (int c = 0; c < 4; c++) std::swap(a[col][c], a[pivot][c]);
+
+    for (int r = 0; r < 3; r++) {
+      if (r == col) continue;
+      const double factor = a[r][col] / a[col][col];
+      for (int c = col; c < 4; c++) a[r][c] -= factor * a[col][c];
+    }
+  }
+
+  result.kS = a[0][3] / a[0][0];
+  result.kV = a[1][3] / a[1][1];
+  result.kA = a[2][3] / a[2][2];
+
+  // Goodness of fit
+  double mean = 0;
+  for (const Point &p : points) mean += p.voltage;
+  mean /= points.size();
+
+  double residual = 0, total = 0;
+  for (const Point &p : points) {
+    const double predicted = result.kS * (p.velocity > 0 ? 1 : -1) + result.kV * p.velocity + result.kA * p.acceleration;
+    residual += (p.voltage - predicted) * (p.voltage - predicted);
+    total += (p.voltage - mean) * (p.voltage - mean);
+  }
+  result.r2 = total > 0 ? 1 - residual / total : 0;
+  result.ok = true;
+
+  return result;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s sysid_*.csv > drive_constants.h\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<Point> linear, angular;
+  for (int i = 1; i < argc; i++) {
+    const bool is_angular = strstr(argv[i], "angular") != nullptr;
+    if (!load(argv[i], is_angular, is_angular ? angular : linear)) {
+      fprintf(stderr, "can't read %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  const Fit lin = fit(linear);
+  const Fit ang = fit(angular);
+  if (!lin.ok || !ang.ok) {
+    fprintf(stderr, "not enough moving samples (linear %zu, angular %zu)\n", lin.samples, ang.samples);
+    return 1;
+  }
+
+  fprintf(stderr, "linear:  kS %.1f  kV %.1f  kA %.1f  (r^2 %.3f, %zu samples)\n", lin.kS, lin.kV, lin.kA, lin.r2, lin.samples);
+  fprintf(stderr, "angular: kS %.1f  kV %.1f  kA %.1f  (r^2 %.3f, %zu samples)\n", ang.kS, ang.kV, ang.kA, ang.r2, ang.samples);
+
+  printf("// drive_constants.h - contains drivetrain feedforward #defines\n");
+  printf("//\n");
+  printf("// Generated by tools/sysid_fit.cpp (linear r^2 %.3f, angular r^2 %.3f).\n", lin.r2, ang.r2);
+  printf("\n#ifndef _DRIVE_CONSTANTS_H_\n#define _DRIVE_CONSTANTS_H_\n\n");
+  printf("// Linear: mV, mV per m/s, mV per m/s^2\n");
+  printf("#define DRIVE_LINEAR_KS %.1f\n#define DRIVE_LINEAR_KV %.1f\n#define DRIVE_LINEAR_KA %.1f\n\n", lin.kS, lin.kV, lin.kA);
+  printf("// Angular, in terms of each side's wheel speed while turning (scrub makes these higher)\n");
+  printf("#define DRIVE_ANGULAR_KS %.1f\n#define DRIVE_ANGULAR_KV %.1f\n#define DRIVE_ANGULAR_KA %.1f\n\n", ang.kS, ang.kV, ang.kA);
+  printf("// Feedback, mV per m/s of velocity error\n#define DRIVE_VELOCITY_KP 4000.0\n\n");
+  printf("// Limit on the acceleration the feedforward is asked for, m/s^2\n#define DRIVE_MAX_ACCEL 4.0\n\n");
+  printf("#endif  // #ifndef _DRIVE_CONSTANTS_H_\n");
+
+  return 0;
+}
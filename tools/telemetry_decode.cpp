@@ -0,0 +1,187 @@
+// telemetry_decode.cpp - host-side decoder for /usd/telemetry_NNN.bin
+//
+// Build: g++ -std=c++17 -O2 -Iinclude -o telemetry_decode tools/telemetry_decode.cpp
+// Usage: ./telemetry_decode telemetry_001.bin match
+//
+// Writes one CSV per channel (match_pose.csv, match_motors.csv, ...) with a
+// session column (one per session header, each file starts with one), time
+// in us, then one column per field. Array fields are expanded to name_0,
+// name_1, ... The schema is read from each session header, so old logs
+// decode with a newer tool. Decoding stops at the zero filled tail.
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "telemetry_format.h"
+
+using namespace telemetry;
+
+struct FieldSchema {
+  std::string name;
+  FIELD_TYPE type;
+  std::uint8_t count;
+};
+
+struct ChannelSchema {
+  std::string name;
+  std::vector<FieldSchema> fields;
+  std::size_t size = 0;
+  FILE *out = nullptr;
+};
+
+struct Reader {
+  const std::vector<std::uint8_t> &data;
+  std::size_t pos = 0;
+
+  bool has(std::size_t n) const { return pos + n <= data.size(); }
+  std::uint8_t byte() { return data[pos++]; }
+
+  bool string(std::string &out) {
+    if (!has(1)) return false;
+    const std::size_t length = byte();
+    if (!has(length)) return false;
+    out.assign(reinterpret_cast<const char *>(&data[pos]), length);
+    pos += length;
+    return true;
+  }
+};
+
+// Print one little-endian value of the given type
+void print_value(FILE *out, FIELD_TYPE type, const std::uint8_t *p) {
+  switch (type) {
+    case FIELD_U8: fprintf(out, "%u", p[0]); break;
+    case FIELD_I8: fprintf(out, "%d", static_cast<std::int8_t>(p[0])); break;
+    case FIELD_U16: { std::uint16_t v; std::memcpy(&v, p, 2); fprintf(out, "%u", v); break; }
+    case FIELD_I16: { std::int16_t v; std::memcpy(&v, p, 2); fprintf(out, "%d", v); break; }
+    case FIELD_U32: { std::uint32_t v; std::memcpy(&v, p, 4); fprintf(out, "%u", v); break; }
+    case FIELD_I32: { std::int32_t v; std::memcpy(&v, p, 4); fprintf(out, "%d", v); break; }
+    case FIELD_F32: { float v; std::memcpy(&v, p, 4); fprintf(out, "%.6g", v); break; }
+  }
+}
+
+// Parse a session header (after the CHANNEL_SESSION byte) into `channels`
+bool read_session(Reader &in, std::map<int, ChannelSchema> &channels, const std::string &prefix) {
+  if (!in.has(sizeof(MAGIC) + 2) || std::memcmp(&in.data[in.pos], MAGIC, sizeof(MAGIC)) != 0) return false;
+  in.pos += sizeof(MAGIC);
+
+  const std::uint8_t version = in.byte();
+  if (version != VERSION) fprintf(stderr, "warning: log version %u, decoder version %u\n", version, VERSION);
+
+  const std::uint8_t count = in.byte();
+  for (int c = 0; c < count; c++) {
+    if (!in.has(1)) return false;
+    const int id = in.byte();
+
+    ChannelSchema schema;
+    if (!in.string(schema.name) || !in.has(1)) return false;
+    const std::uint8_t field_count = in.byte();
+
+    for (int f = 0; f < field_count; f++) {
+      FieldSchema field;
+      if (!in.string(field.name) || !in.has(2)) return false;
+      field.type = static_cast<FIELD_TYPE>(in.byte());
+      field.count = in.byte();
+      schema.size += field_size(field.type) * field.count;
+      schema.fields.push_back(field);
+    }
+
+    // Keep the file open across sessions if the channel already exists
+    auto existing = channels.find(id);
+    if (existing != channels.end()) {
+      schema.out = existing->second.out;
+    }
+    else {
+      const std::string path = prefix + "_" + schema.name + ".csv";
+      schema.out = fopen(path.c_str(), "w");
+      if (schema.out == nullptr) {
+        fprintf(stderr, "can't write %s\n", path.c_str());
+        return false;
+      }
+
+      fprintf(schema.out, "session,time_us");
+      for (const FieldSchema &field : schema.fields) {
+        if (field.count == 1) fprintf(schema.out, ",%s", field.name.c_str());
+        else for (int i = 0; i < field.count; i++) fprintf(schema.out, ",%s_%d", field.name.c_str(), i);
+      }
+      fprintf(schema.out, "\n");
+    }
+
+    channels[id] = schema;
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s telemetry_NNN.bin out_prefix\n", argv[0]);
+    return 1;
+  }
+
+  FILE *file = fopen(argv[1], "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::vector<std::uint8_t> data;
+  std::uint8_t chunk[4096];
+  std::size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + n);
+  fclose(file);
+
+  std::map<int, ChannelSchema> channels;
+  Reader in{data};
+  int session = -1;
+  std::uint64_t time = 0;
+  std::size_t records = 0;
+
+  while (in.has(1)) {
+    const std::uint8_t id = in.byte();
+
+    // The brain preallocates each file with zeros, the first zero that
+    // doesn't start a session header is the end of the data
+    if (id == CHANNEL_SESSION && (!in.has(1) || data[in.pos] == 0)) break;
+
+    if (id == CHANNEL_SESSION) {
+      if (!read_session(in, channels, argv[2])) {
+        fprintf(stderr, "bad session header at byte %zu\n", in.pos);
+        return 1;
+      }
+      session++;
+      time = 0;
+      continue;
+    }
+
+    auto channel = channels.find(id);
+    if (session < 0 || channel == channels.end()) {
+      fprintf(stderr, "unknown channel %u at byte %zu, stopping\n", id, in.pos - 1);
+      break;
+    }
+
+    std::uint64_t delta;
+    const std::size_t varint = get_varint(&data[in.pos], data.size() - in.pos, delta);
+    if (varint == 0 || !in.has(varint + channel->second.size)) break;    // truncated tail, power cut mid-write
+    in.pos += varint;
+    time += delta;
+
+    FILE *out = channel->second.out;
+    fprintf(out, "%d,%llu", session, static_cast<unsigned long long>(time));
+    for (const FieldSchema &field : channel->second.fields) {
+      for (int i = 0; i < field.count; i++) {
+        fputc(',', out);
+        print_value(out, field.type, &data[in.pos]);
+        in.pos += field_size(field.type);
+      }
+    }
+    fputc('\n', out);
+    records++;
+  }
+
+  for (auto &entry : channels) fclose(entry.second.out);
+  fprintf(stderr, "%zu records, %d sessions\n", records, session + 1);
+  return 0;
+}